@@ -0,0 +1,69 @@
+#ifndef JSON_BATCH_H
+#define JSON_BATCH_H
+
+#include "JsonParser.h"
+#include "JsonValue.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace json {
+
+class JsonSchema;
+
+struct BatchOptions {
+    // Parser threads; 0 picks the hardware concurrency.
+    unsigned jobs = 0;
+    // Files read ahead of the parsers; 0 uses twice the number of jobs.
+    size_t readAhead = 0;
+    // Deliver results in input order; otherwise as soon as they finish.
+    bool ordered = true;
+    ParseOptions parse;
+    // When set, files are validated while they are parsed and a violation
+    // fails the file before its tree is built.
+    const JsonSchema* schema = nullptr;
+    // Only check that each file parses (and matches `schema`): the task is
+    // not called and results carry no output. With a schema no tree is built.
+    bool validateOnly = false;
+};
+
+struct BatchInput {
+    std::string path;
+    std::string name;   // path relative to the directory it was found in; not unique across arguments
+};
+
+struct BatchResult {
+    size_t index;
+    const BatchInput* input;
+    bool ok;
+    std::string output;
+    std::string error;
+};
+
+// Parses many files with a bounded pool of threads. A reader thread loads
+// files ahead of the parsers so I/O overlaps with parsing, and at most
+// readAhead + jobs files are held in memory at once.
+class JsonBatch {
+public:
+    // Turns each document into output text; throwing marks the file as failed.
+    using Task = std::function<std::string(const JsonValue&)>;
+    using ResultHandler = std::function<void(const BatchResult&)>;
+
+    // Expands directories into the .json files below them, sorted by path.
+    static std::vector<BatchInput> collectInputs(const std::vector<std::string>& paths);
+
+    // Names are relative to the argument they came from, so two arguments
+    // can yield the same one (a.json and other/a.json). Throws
+    // std::runtime_error naming both paths when outputs written under the
+    // input names would overwrite each other.
+    static void requireDistinctNames(const std::vector<BatchInput>& inputs);
+
+    // Runs `task` over every input and hands results to `onResult` on the
+    // calling thread. Returns the number of files that failed.
+    static size_t run(const std::vector<BatchInput>& inputs, const Task& task,
+                      const ResultHandler& onResult, const BatchOptions& options = BatchOptions());
+};
+
+} // namespace json
+
+#endif // JSON_BATCH_H
@@ -0,0 +1,188 @@
+#ifndef JSON_CURSOR_H
+#define JSON_CURSOR_H
+
+#include "JsonParser.h"
+#include "JsonValue.h"
+#include <cstddef>
+#include <iosfwd>
+#include <iterator>
+#include <memory>
+#include <string>
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+#define JSON_HAS_COROUTINES 1
+#endif
+#endif
+
+namespace json {
+
+// Pull-style reader over the elements of a top-level JSON array. The input
+// is lexed incrementally and each element is only materialized when asked
+// for, so memory stays bounded by the largest element rather than the file.
+//
+//     JsonCursor cursor("export.json");
+//     while (cursor.next()) {
+//         JsonValue record = cursor.readValue();   // or cursor.skip()
+//     }
+class JsonCursor {
+public:
+    explicit JsonCursor(const std::string& filename, const ParseOptions& options = ParseOptions());
+
+    // Reads from a caller-owned stream, which must outlive the cursor.
+    explicit JsonCursor(std::istream& input, const ParseOptions& options = ParseOptions());
+
+    ~JsonCursor();
+
+    JsonCursor(const JsonCursor&) = delete;
+    JsonCursor& operator=(const JsonCursor&) = delete;
+
+    // Moves to the next element, skipping the current one if it was neither
+    // read nor skipped. Returns false once the closing ']' is reached; only
+    // whitespace may follow it.
+    bool next();
+
+    // Builds the current element. Valid once after each successful next().
+    JsonValue readValue();
+
+    // Consumes the current element without building it.
+    void skip();
+
+    // Whether the document is an array, judged from its first token. Before
+    // the first next(), a caller that also accepts other documents can fall
+    // back to readDocument().
+    bool isArray();
+
+    // Builds the whole document, whatever its type, exactly as
+    // JsonParser::parse() would. Only valid before the first next().
+    JsonValue readDocument();
+
+    // Zero-based position of the current element.
+    size_t index() const { return index_; }
+
+    // Input iterator that reads every remaining element in turn.
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = JsonValue;
+        using difference_type = std::ptrdiff_t;
+        using pointer = JsonValue*;
+        using reference = JsonValue&;
+
+        iterator() : cursor_(nullptr) {}
+        explicit iterator(JsonCursor* cursor) : cursor_(cursor) { fetch(); }
+
+        JsonValue& operator*() { return value_; }
+        JsonValue* operator->() { return &value_; }
+        iterator& operator++() { fetch(); return *this; }
+
+        bool operator==(const iterator& other) const { return cursor_ == other.cursor_; }
+        bool operator!=(const iterator& other) const { return cursor_ != other.cursor_; }
+
+    private:
+        void fetch() {
+            if (cursor_ && cursor_->next()) {
+                value_ = cursor_->readValue();
+            } else {
+                cursor_ = nullptr;
+            }
+        }
+
+        JsonCursor* cursor_;
+        JsonValue value_;
+    };
+
+    iterator begin() { return iterator(this); }
+    iterator end() { return iterator(); }
+
+private:
+    enum class State { Start, AtElement, AfterElement, Done };
+
+    void finish();
+    void requireElement(const char* action) const;
+
+    std::unique_ptr<std::istream> file_;
+    std::unique_ptr<JsonParser> parser_;
+    State state_;
+    size_t index_;
+};
+
+#ifdef JSON_HAS_COROUTINES
+
+// Minimal lazily-evaluated generator for C++20 builds.
+template <typename T>
+class Generator {
+public:
+    struct promise_type {
+        std::optional<T> current;
+        std::exception_ptr error;
+
+        Generator get_return_object() { return Generator(Handle::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always yield_value(T value) {
+            current = std::move(value);
+            return {};
+        }
+        void return_void() {}
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+
+    using Handle = std::coroutine_handle<promise_type>;
+
+    class iterator {
+    public:
+        explicit iterator(Handle handle) : handle_(handle) {}
+
+        T& operator*() const { return *handle_.promise().current; }
+        iterator& operator++() {
+            resume(handle_);
+            return *this;
+        }
+        bool operator==(std::default_sentinel_t) const { return !handle_ || handle_.done(); }
+
+    private:
+        Handle handle_;
+    };
+
+    explicit Generator(Handle handle) : handle_(handle) {}
+    Generator(Generator&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+    Generator(const Generator&) = delete;
+    Generator& operator=(const Generator&) = delete;
+    ~Generator() {
+        if (handle_) handle_.destroy();
+    }
+
+    iterator begin() {
+        resume(handle_);
+        return iterator(handle_);
+    }
+    std::default_sentinel_t end() { return {}; }
+
+private:
+    static void resume(Handle handle) {
+        handle.resume();
+        if (handle.promise().error) {
+            std::rethrow_exception(handle.promise().error);
+        }
+    }
+
+    Handle handle_;
+};
+
+// Yields the remaining elements of the cursor one at a time.
+inline Generator<JsonValue> elements(JsonCursor& cursor) {
+    while (cursor.next()) {
+        co_yield cursor.readValue();
+    }
+}
+
+#endif // JSON_HAS_COROUTINES
+
+} // namespace json
+
+#endif // JSON_CURSOR_H
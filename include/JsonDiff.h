@@ -0,0 +1,68 @@
+#ifndef JSON_DIFF_H
+#define JSON_DIFF_H
+
+#include "JsonValue.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace json {
+
+struct DiffOptions {
+    // Worker threads used for large containers; 0 picks the hardware concurrency.
+    unsigned threads = 0;
+    // Number of changed members a container needs before its comparison is
+    // split across threads.
+    size_t parallelThreshold = 1024;
+    // Largest LCS table (in cells) used to align array elements; bigger
+    // arrays fall back to positional comparison.
+    size_t maxLcsCells = size_t(1) << 22;
+};
+
+// A 128-bit structural hash, built from two independently mixed 64-bit lanes.
+struct SubtreeHash {
+    uint64_t low;
+    uint64_t high;
+
+    bool operator==(const SubtreeHash& other) const { return low == other.low && high == other.high; }
+    bool operator!=(const SubtreeHash& other) const { return !(*this == other); }
+};
+
+// Merkle-style hashes of every subtree in a document, computed once in a
+// single post-order pass. Equal subtrees hash equally. The diff trusts a
+// match and skips the pair in O(1): two different subtrees collide with a
+// probability around 2^-128, far below the odds of a hardware error.
+class SubtreeHashes {
+public:
+    explicit SubtreeHashes(const JsonValue& root);
+
+    // Containers are looked up; scalars are cheap enough to hash on demand.
+    SubtreeHash get(const JsonValue& value) const;
+
+private:
+    struct Slot {
+        const JsonValue* value = nullptr;
+        SubtreeHash hash{};
+    };
+
+    void insert(const JsonValue* value, SubtreeHash hash);
+    void place(const Slot& slot);
+
+    // Open-addressing table keyed by container address, kept at most half full.
+    std::vector<Slot> slots_;
+    size_t count_ = 0;
+};
+
+class JsonDiff {
+public:
+    // Returns an RFC 6902 JSON Patch (an array of operations) that turns
+    // `from` into `to`.
+    static JsonValue diff(const JsonValue& from, const JsonValue& to, const DiffOptions& options = DiffOptions());
+
+    // Structural hash of a single value.
+    static SubtreeHash hash(const JsonValue& value);
+};
+
+} // namespace json
+
+#endif // JSON_DIFF_H
@@ -1,6 +1,8 @@
 #ifndef JSON_LEXER_H
 #define JSON_LEXER_H
 
+#include <exception>
+#include <iosfwd>
 #include <string>
 #include <vector>
 
@@ -34,25 +36,47 @@ struct Token {
 
 class JsonLexer {
 public:
-    explicit JsonLexer(const std::string& input);
+    // maxDepth bounds bracket nesting so hostile input fails before it is
+    // fully tokenized; 0 disables the check.
+    explicit JsonLexer(const std::string& input, size_t maxDepth = 0);
+    
+    // Reads the input incrementally in fixed-size chunks; the stream must
+    // outlive the lexer. Use next() to pull tokens with bounded memory.
+    explicit JsonLexer(std::istream& input, size_t maxDepth = 0);
     
     std::vector<Token> tokenize();
     
+    // Returns the next token, or END_OF_FILE once the input is exhausted.
+    // Nesting depth is not checked here; the parser enforces it. Tokens are
+    // scanned ahead in small batches; a lexical error is only thrown once
+    // the tokens before it have been returned.
+    Token next();
+    
 private:
+    void scanBatch();
+    Token scanToken();
     void skipWhitespace();
     Token nextToken();
     Token parseString();
     Token parseNumber();
     Token parseKeyword();
     
-    char peek() const;
+    char peek();
     char advance();
-    bool isAtEnd() const;
+    bool isAtEnd();
+    bool refill();
     
     std::string input_;
     size_t current_;
     size_t line_;
     size_t column_;
+    size_t maxDepth_;
+    std::istream* stream_;
+    
+    // Tokens scanned ahead for next(), and the error that ended the scan.
+    std::vector<Token> pending_;
+    size_t pendingIndex_;
+    std::exception_ptr pendingError_;
 };
 
 } // namespace json
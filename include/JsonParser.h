@@ -3,33 +3,66 @@
 
 #include "JsonValue.h"
 #include "JsonLexer.h"
+#include <iosfwd>
+#include <memory>
 #include <vector>
 #include <string>
 
 namespace json {
 
+struct ParseOptions {
+    // Maximum nesting depth of arrays and objects; 0 disables the limit.
+    size_t maxDepth = 10000;
+};
+
 class JsonParser {
 public:
-    explicit JsonParser(const std::string& input);
+    explicit JsonParser(const std::string& input, const ParseOptions& options = ParseOptions());
+    
+    // Pulls tokens from the stream as parsing proceeds instead of lexing the
+    // whole input up front. The stream must outlive the parser.
+    explicit JsonParser(std::istream& input, const ParseOptions& options = ParseOptions());
+    ~JsonParser();
     
     JsonValue parse();
     
-    static JsonValue parseFile(const std::string& filename);
+    static JsonValue parseFile(const std::string& filename, const ParseOptions& options = ParseOptions());
     
 private:
-    JsonValue parseValue();
-    JsonValue parseObject();
-    JsonValue parseArray();
+    friend class JsonCursor;
+    
+    // A container that is still being filled, plus the key its next member goes under.
+    struct Frame {
+        JsonValue container;
+        std::string key;
+    };
+    
+    // `outerDepth` is the nesting depth of the container holding the value, which
+    // counts toward ParseOptions::maxDepth.
+    JsonValue parseValue(size_t outerDepth = 0);
+    void skipValue(size_t outerDepth = 0);
+    void discardConsumedTokens();
+    void readKey(Frame& frame);
+    void appendElement(JsonValue& array, JsonValue&& element);
+    
+    JsonValue recordValue(JsonValue value);
+    void recordMember(const JsonValue& object, const std::string& key);
+    void enterContainer(size_t depth, const Token& token);
+    void expectEndOfInput();
     
-    const Token& peek() const;
+    const Token& peek();
     const Token& advance();
-    bool check(TokenType type) const;
+    bool check(TokenType type);
     bool match(TokenType type);
     void expect(TokenType type, const std::string& message);
-    bool isAtEnd() const;
+    bool isAtEnd();
 
+    // Set only when streaming; tokens_ then holds a window of pulled tokens.
+    std::unique_ptr<JsonLexer> lexer_;
     std::vector<Token> tokens_;
     size_t current_;
+    ParseOptions options_;
+    bool collectStats_;
 };
 
 } // namespace json
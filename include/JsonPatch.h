@@ -0,0 +1,24 @@
+#ifndef JSON_PATCH_H
+#define JSON_PATCH_H
+
+#include "JsonValue.h"
+
+namespace json {
+
+// Applies patches to a document in place. Work is proportional to the patch,
+// not the document: every operation resolves its pointer and moves payloads
+// rather than copying them. Both functions are transactional; if any
+// operation fails, the changes made so far are undone and the exception is
+// rethrown with the document unchanged.
+class JsonPatch {
+public:
+    // RFC 6902 JSON Patch: `patch` is an array of add/remove/replace/move/copy/test operations.
+    static void apply(JsonValue& document, const JsonValue& patch);
+
+    // RFC 7396 JSON Merge Patch.
+    static void applyMerge(JsonValue& document, const JsonValue& patch);
+};
+
+} // namespace json
+
+#endif // JSON_PATCH_H
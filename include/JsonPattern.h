@@ -0,0 +1,38 @@
+#ifndef JSON_PATTERN_H
+#define JSON_PATTERN_H
+
+#include <memory>
+#include <string>
+
+namespace json {
+
+struct PatternProgram;
+
+// Regular expressions for the JSON Schema `pattern` keyword. The syntax is
+// ECMA-262 without backreferences or lookaround: alternation, groups,
+// greedy and lazy quantifiers, character classes with the \d \w \s escapes,
+// `.` and the ^ $ \b \B assertions. Both the pattern and the subject are
+// read as UTF-8 and matched by code point.
+//
+// A pattern is compiled to an automaton, and search() simulates every
+// thread of it in lockstep (a Pike VM). Matching takes time linear in the
+// length of the subject and never recurses, however long the string is.
+class JsonPattern {
+public:
+    // Throws std::runtime_error for malformed patterns and for features
+    // outside the supported subset.
+    explicit JsonPattern(const std::string& source);
+
+    // True when the pattern matches somewhere in `text`, like RegExp.test().
+    bool search(const std::string& text) const;
+
+    const std::string& source() const { return source_; }
+
+private:
+    std::string source_;
+    std::shared_ptr<const PatternProgram> program_;
+};
+
+} // namespace json
+
+#endif // JSON_PATTERN_H
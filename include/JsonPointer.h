@@ -0,0 +1,23 @@
+#ifndef JSON_POINTER_H
+#define JSON_POINTER_H
+
+#include <string>
+#include <vector>
+
+namespace json {
+
+// RFC 6901 JSON Pointer helpers, used by the diff and patch modules.
+
+// Escapes a single reference token: "~" becomes "~0" and "/" becomes "~1".
+std::string escapePointerToken(const std::string& token);
+
+// Splits a pointer like /a/b~1c/0 into unescaped tokens: a, b/c, 0.
+// The empty pointer refers to the whole document and yields no tokens.
+std::vector<std::string> splitPointer(const std::string& pointer);
+
+// Inverse of splitPointer.
+std::string joinPointer(const std::vector<std::string>& tokens);
+
+} // namespace json
+
+#endif // JSON_POINTER_H
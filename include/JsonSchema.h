@@ -0,0 +1,57 @@
+#ifndef JSON_SCHEMA_H
+#define JSON_SCHEMA_H
+
+#include "JsonParser.h"
+#include "JsonValue.h"
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+namespace json {
+
+struct SchemaTables;
+
+// JSON Schema (draft 2020-12) validator for the keywords type, enum, const,
+// properties, required, additionalProperties, items, minimum, maximum,
+// exclusiveMinimum, exclusiveMaximum, minLength, maxLength, minItems,
+// maxItems, minProperties, maxProperties and pattern.
+//
+// The schema is compiled once into flat tables: property names are sorted
+// for binary search and patterns are compiled up front (see JsonPattern). A
+// compiled schema is immutable, cheap to copy and safe to share between
+// threads.
+//
+//     JsonSchema schema = JsonSchema::fromFile("request.schema.json");
+//     JsonValue body = schema.parse(requestText);   // throws on syntax errors and violations
+class JsonSchema {
+public:
+    // Throws std::runtime_error for malformed schemas and for keywords
+    // outside the supported subset that would change the outcome ($ref,
+    // allOf, anyOf, ...). Annotations such as title and format are ignored.
+    explicit JsonSchema(const JsonValue& schema);
+
+    static JsonSchema fromFile(const std::string& filename, const ParseOptions& options = ParseOptions());
+
+    // Checks a parsed document. validate() throws std::runtime_error naming
+    // the JSON Pointer of the first failing value.
+    bool isValid(const JsonValue& value) const;
+    void validate(const JsonValue& value) const;
+
+    // Parses with JsonParser, then validates the tree.
+    JsonValue parse(const std::string& input, const ParseOptions& options = ParseOptions()) const;
+    JsonValue parse(std::istream& input, const ParseOptions& options = ParseOptions()) const;
+
+    // Accepts exactly what parse() accepts without keeping the document. A
+    // top-level array is read through a JsonCursor and each element is
+    // validated and dropped, stopping at the first invalid one; any other
+    // document (or a root schema with enum or const) is built whole first.
+    void validateStream(std::istream& input, const ParseOptions& options = ParseOptions()) const;
+    void validateStream(const std::string& input, const ParseOptions& options = ParseOptions()) const;
+
+private:
+    std::shared_ptr<const SchemaTables> tables_;
+};
+
+} // namespace json
+
+#endif // JSON_SCHEMA_H
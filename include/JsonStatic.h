@@ -0,0 +1,820 @@
+#ifndef JSON_STATIC_H
+#define JSON_STATIC_H
+
+#include "JsonValue.h"
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+namespace json {
+
+// Compile-time parsing of JSON string literals:
+//
+//     static constexpr auto kLimits = JSON_STATIC(R"({"maxUsers": 100, "names": ["a", "b"]})");
+//     static_assert(kLimits["maxUsers"].asNumber() == 100);
+//
+// The result is a constant table of nodes that lives in read-only data, so
+// nothing is parsed or allocated at run time. Object members are sorted by
+// key, as in JsonValue, and looked up by binary search. Malformed input is
+// a compile error.
+
+struct StaticNode {
+    ValueType type;
+    bool boolean;
+    double number;
+    size_t text;        // string payload: offset into the character table
+    size_t textLength;
+    size_t key;         // member key when the parent is an object
+    size_t keyLength;
+    size_t parent;
+    size_t firstChild;  // offset into the children table
+    size_t childCount;
+};
+
+// Read-only view of one node of a static document.
+class StaticJson {
+public:
+    constexpr StaticJson(const StaticNode* nodes, const size_t* children, const char* chars, size_t index)
+        : nodes_(nodes), children_(children), chars_(chars), index_(index) {}
+
+    constexpr ValueType getType() const { return node().type; }
+
+    constexpr bool isNull() const { return getType() == ValueType::NULL_TYPE; }
+    constexpr bool isBool() const { return getType() == ValueType::BOOLEAN; }
+    constexpr bool isNumber() const { return getType() == ValueType::NUMBER; }
+    constexpr bool isString() const { return getType() == ValueType::STRING; }
+    constexpr bool isArray() const { return getType() == ValueType::ARRAY; }
+    constexpr bool isObject() const { return getType() == ValueType::OBJECT; }
+
+    constexpr bool asBool() const {
+        if (!isBool()) throw std::runtime_error("JsonValue is not a boolean");
+        return node().boolean;
+    }
+
+    constexpr double asNumber() const {
+        if (!isNumber()) throw std::runtime_error("JsonValue is not a number");
+        return node().number;
+    }
+
+    constexpr std::string_view asString() const {
+        if (!isString()) throw std::runtime_error("JsonValue is not a string");
+        return std::string_view(chars_ + node().text, node().textLength);
+    }
+
+    constexpr size_t size() const {
+        if (!isArray() && !isObject()) throw std::runtime_error("JsonValue is not an array or object");
+        return node().childCount;
+    }
+
+    constexpr StaticJson operator[](size_t index) const {
+        if (!isArray()) throw std::runtime_error("JsonValue is not an array");
+        if (index >= node().childCount) throw std::out_of_range("Array index out of range");
+        return child(index);
+    }
+
+    constexpr StaticJson operator[](std::string_view key) const {
+        if (!isObject()) throw std::runtime_error("JsonValue is not an object");
+        size_t position = lowerBound(key);
+        if (position == node().childCount || child(position).key() != key) {
+            throw std::out_of_range("Key not found in object");
+        }
+        return child(position);
+    }
+
+    constexpr bool hasKey(std::string_view key) const {
+        if (!isObject()) return false;
+        size_t position = lowerBound(key);
+        return position < node().childCount && child(position).key() == key;
+    }
+
+    // Key of the member at `index` of an object, in sorted order.
+    constexpr std::string_view keyAt(size_t index) const {
+        if (!isObject()) throw std::runtime_error("JsonValue is not an object");
+        if (index >= node().childCount) throw std::out_of_range("Object index out of range");
+        return child(index).key();
+    }
+
+    // Copies the subtree into a mutable JsonValue.
+    JsonValue toJsonValue() const;
+    operator JsonValue() const { return toJsonValue(); }
+
+private:
+    constexpr const StaticNode& node() const { return nodes_[index_]; }
+
+    constexpr StaticJson child(size_t position) const {
+        return StaticJson(nodes_, children_, chars_, children_[node().firstChild + position]);
+    }
+
+    constexpr std::string_view key() const {
+        return std::string_view(chars_ + node().key, node().keyLength);
+    }
+
+    constexpr size_t lowerBound(std::string_view key) const {
+        size_t low = 0;
+        size_t high = node().childCount;
+        while (low < high) {
+            size_t mid = low + (high - low) / 2;
+            if (child(mid).key() < key) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        return low;
+    }
+
+    const StaticNode* nodes_;
+    const size_t* children_;
+    const char* chars_;
+    size_t index_;
+};
+
+template <size_t Nodes, size_t Chars>
+struct StaticDocument {
+    StaticNode nodes[Nodes];
+    size_t children[Nodes];
+    char chars[Chars + 1];
+
+    constexpr StaticJson root() const { return StaticJson(nodes, children, chars, 0); }
+
+    constexpr ValueType getType() const { return root().getType(); }
+    constexpr bool isNull() const { return root().isNull(); }
+    constexpr bool isBool() const { return root().isBool(); }
+    constexpr bool isNumber() const { return root().isNumber(); }
+    constexpr bool isString() const { return root().isString(); }
+    constexpr bool isArray() const { return root().isArray(); }
+    constexpr bool isObject() const { return root().isObject(); }
+    constexpr bool asBool() const { return root().asBool(); }
+    constexpr double asNumber() const { return root().asNumber(); }
+    constexpr std::string_view asString() const { return root().asString(); }
+    constexpr size_t size() const { return root().size(); }
+    constexpr StaticJson operator[](size_t index) const { return root()[index]; }
+    constexpr StaticJson operator[](std::string_view key) const { return root()[key]; }
+    constexpr bool hasKey(std::string_view key) const { return root().hasKey(key); }
+    constexpr std::string_view keyAt(size_t index) const { return root().keyAt(index); }
+
+    JsonValue toJsonValue() const { return root().toJsonValue(); }
+    operator JsonValue() const { return toJsonValue(); }
+};
+
+namespace detail {
+
+constexpr size_t kNoParent = static_cast<size_t>(-1);
+
+struct StaticCounts {
+    size_t nodes;
+    size_t chars;
+};
+
+// Fixed-capacity unsigned integer used for exact decimal to binary
+// conversion in constant expressions. 128 32-bit limbs cover the largest
+// intermediate: 800 significant digits scaled down to the subnormal range.
+class StaticBigInt {
+public:
+    constexpr void multiplyAdd(uint32_t factor, uint32_t addend) {
+        uint64_t carry = addend;
+        for (size_t i = 0; i < size_; ++i) {
+            uint64_t value = uint64_t(limbs_[i]) * factor + carry;
+            limbs_[i] = static_cast<uint32_t>(value);
+            carry = value >> 32;
+        }
+        if (carry != 0) push(static_cast<uint32_t>(carry));
+    }
+
+    constexpr void multiplyPow10(int exponent) {
+        for (; exponent >= 9; exponent -= 9) multiplyAdd(1000000000u, 0);
+        uint32_t factor = 1;
+        for (; exponent > 0; --exponent) factor *= 10;
+        multiplyAdd(factor, 0);
+    }
+
+    constexpr void shiftLeft(size_t bits) {
+        if (size_ == 0) return;
+        size_t words = bits / 32;
+        unsigned offset = static_cast<unsigned>(bits % 32);
+        uint32_t spill = offset ? limbs_[size_ - 1] >> (32 - offset) : 0;
+        if (size_ + words + (spill ? 1 : 0) > kLimbs) throw std::runtime_error("Number too long");
+        if (spill) limbs_[size_ + words] = spill;
+        for (size_t i = size_; i-- > 0;) {
+            uint32_t low = offset && i > 0 ? limbs_[i - 1] >> (32 - offset) : 0;
+            limbs_[i + words] = offset ? (limbs_[i] << offset) | low : limbs_[i];
+        }
+        for (size_t i = 0; i < words; ++i) limbs_[i] = 0;
+        size_ += words + (spill ? 1 : 0);
+    }
+
+    constexpr void shiftRightOne() {
+        for (size_t i = 0; i < size_; ++i) {
+            uint32_t high = i + 1 < size_ ? limbs_[i + 1] << 31 : 0;
+            limbs_[i] = (limbs_[i] >> 1) | high;
+        }
+        trim();
+    }
+
+    constexpr int compare(const StaticBigInt& other) const {
+        if (size_ != other.size_) return size_ < other.size_ ? -1 : 1;
+        for (size_t i = size_; i-- > 0;) {
+            if (limbs_[i] != other.limbs_[i]) return limbs_[i] < other.limbs_[i] ? -1 : 1;
+        }
+        return 0;
+    }
+
+    // Requires *this >= other.
+    constexpr void subtract(const StaticBigInt& other) {
+        int64_t borrow = 0;
+        for (size_t i = 0; i < size_; ++i) {
+            int64_t value = int64_t(limbs_[i]) - (i < other.size_ ? int64_t(other.limbs_[i]) : 0) - borrow;
+            borrow = value < 0 ? 1 : 0;
+            limbs_[i] = static_cast<uint32_t>(value + (borrow << 32));
+        }
+        trim();
+    }
+
+    // Replaces *this with the remainder of *this / divisor and returns the
+    // quotient, which must be below 2^55.
+    constexpr uint64_t divideSmallQuotient(const StaticBigInt& divisor) {
+        StaticBigInt shifted = divisor;
+        shifted.shiftLeft(54);
+        uint64_t quotient = 0;
+        for (int bit = 54; bit >= 0; --bit) {
+            if (compare(shifted) >= 0) {
+                subtract(shifted);
+                quotient |= uint64_t(1) << bit;
+            }
+            shifted.shiftRightOne();
+        }
+        return quotient;
+    }
+
+    constexpr size_t bitLength() const {
+        if (size_ == 0) return 0;
+        size_t length = 32 * (size_ - 1);
+        for (uint32_t top = limbs_[size_ - 1]; top != 0; top >>= 1) length++;
+        return length;
+    }
+
+    constexpr bool bit(size_t index) const {
+        return index / 32 < size_ && ((limbs_[index / 32] >> (index % 32)) & 1) != 0;
+    }
+
+    constexpr bool anyBelow(size_t index) const {
+        for (size_t i = 0; i < index / 32 && i < size_; ++i) {
+            if (limbs_[i] != 0) return true;
+        }
+        return index % 32 != 0 && index / 32 < size_ && (limbs_[index / 32] & ((1u << (index % 32)) - 1)) != 0;
+    }
+
+    // Up to 64 bits starting at bit `from`.
+    constexpr uint64_t bits(size_t from, size_t count) const {
+        auto limb = [&](size_t i) { return i < size_ ? uint64_t(limbs_[i]) : 0; };
+        size_t first = from / 32;
+        unsigned offset = static_cast<unsigned>(from % 32);
+        uint64_t value = (limb(first) | (limb(first + 1) << 32)) >> offset;
+        if (offset) value |= limb(first + 2) << (64 - offset);
+        return count < 64 ? value & ((uint64_t(1) << count) - 1) : value;
+    }
+
+private:
+    static constexpr size_t kLimbs = 128;
+
+    constexpr void push(uint32_t limb) {
+        if (size_ == kLimbs) throw std::runtime_error("Number too long");
+        limbs_[size_++] = limb;
+    }
+
+    constexpr void trim() {
+        while (size_ > 0 && limbs_[size_ - 1] == 0) size_--;
+    }
+
+    uint32_t limbs_[kLimbs] = {};
+    size_t size_ = 0;
+};
+
+// Parser usable in constant expressions. It runs twice: measure() sizes the
+// node and character tables, then build() fills tables of exactly that size.
+// Containers are tracked through parent links rather than recursion.
+class StaticParser {
+public:
+    constexpr explicit StaticParser(std::string_view text) : text_(text), pos_(0) {}
+
+    constexpr StaticCounts measure() {
+        StaticCounts counts{0, 0};
+        while (true) {
+            skipWhitespace();
+            if (pos_ >= text_.size()) break;
+            char c = text_[pos_];
+            if (c == '"') {
+                counts.chars += parseString(nullptr);
+                skipWhitespace();
+                if (pos_ >= text_.size() || text_[pos_] != ':') {
+                    counts.nodes++;
+                }
+            } else if (c == '{' || c == '[') {
+                counts.nodes++;
+                pos_++;
+            } else if (c == '}' || c == ']' || c == ',' || c == ':') {
+                pos_++;
+            } else {
+                parseScalar();
+                counts.nodes++;
+            }
+        }
+        if (counts.nodes == 0) {
+            throw std::runtime_error("Empty JSON document");
+        }
+        pos_ = 0;
+        return counts;
+    }
+
+    template <size_t Nodes, size_t Chars>
+    constexpr void build(StaticDocument<Nodes, Chars>& doc) {
+        nodes_ = doc.nodes;
+        children_ = doc.children;
+        chars_ = doc.chars;
+        nodeCapacity_ = Nodes;
+        nodeCount_ = 0;
+        charCount_ = 0;
+        size_t container = kNoParent;
+
+        while (true) {
+            // Parse one value; containers are opened and their first member
+            // (if any) is parsed on the next iteration.
+            skipWhitespace();
+            if (peek() == '{' || peek() == '[') {
+                bool isObject = peek() == '{';
+                pos_++;
+                size_t node = addNode(isObject ? ValueType::OBJECT : ValueType::ARRAY, container);
+                skipWhitespace();
+                if (peek() == (isObject ? '}' : ']')) {
+                    pos_++;
+                } else {
+                    container = node;
+                    if (isObject) readKey();
+                    continue;
+                }
+            } else if (peek() == '"') {
+                size_t node = addNode(ValueType::STRING, container);
+                nodes_[node].text = charCount_;
+                nodes_[node].textLength = parseString(chars_ + charCount_);
+                charCount_ += nodes_[node].textLength;
+            } else {
+                char c = peek();
+                if (c != '-' && !isDigit(c) && c != 't' && c != 'f' && c != 'n') {
+                    throw std::runtime_error("Expected value");
+                }
+                size_t node = addNode(ValueType::NULL_TYPE, container);
+                parseScalar(&nodes_[node]);
+            }
+
+            // Close every container the value completes.
+            while (true) {
+                skipWhitespace();
+                if (container == kNoParent) {
+                    if (pos_ != text_.size()) throw std::runtime_error("Unexpected data after JSON value");
+                    chars_[charCount_] = '\0';
+                    linkChildren();
+                    return;
+                }
+                bool isObject = nodes_[container].type == ValueType::OBJECT;
+                char c = peek();
+                pos_++;
+                if (c == ',') {
+                    if (isObject) readKey();
+                    break;
+                }
+                if (c != (isObject ? '}' : ']')) {
+                    throw std::runtime_error(isObject ? "Expected '}'" : "Expected ']'");
+                }
+                container = nodes_[container].parent;
+            }
+        }
+    }
+
+private:
+    constexpr char peek() const {
+        return pos_ < text_.size() ? text_[pos_] : '\0';
+    }
+
+    constexpr void skipWhitespace() {
+        while (pos_ < text_.size() &&
+               (text_[pos_] == ' ' || text_[pos_] == '\t' || text_[pos_] == '\n' || text_[pos_] == '\r')) {
+            pos_++;
+        }
+    }
+
+    constexpr size_t addNode(ValueType type, size_t parent) {
+        if (nodeCount_ == nodeCapacity_) throw std::runtime_error("Expected value");
+        size_t index = nodeCount_++;
+        StaticNode& node = nodes_[index];
+        node = StaticNode{type, false, 0.0, 0, 0, 0, 0, parent, 0, 0};
+        if (parent != kNoParent && nodes_[parent].type == ValueType::OBJECT) {
+            node.key = pendingKey_;
+            node.keyLength = pendingKeyLength_;
+        }
+        return index;
+    }
+
+    constexpr void readKey() {
+        skipWhitespace();
+        if (peek() != '"') throw std::runtime_error("Expected string key");
+        pendingKey_ = charCount_;
+        pendingKeyLength_ = parseString(chars_ + charCount_);
+        charCount_ += pendingKeyLength_;
+        skipWhitespace();
+        if (peek() != ':') throw std::runtime_error("Expected ':' after key");
+        pos_++;
+    }
+
+    // Decodes a string literal starting at the opening quote into `out`
+    // (when not null) and returns the decoded length.
+    constexpr size_t parseString(char* out) {
+        size_t length = 0;
+        pos_++;
+        while (true) {
+            if (pos_ >= text_.size()) throw std::runtime_error("Unterminated string");
+            char c = text_[pos_++];
+            if (c == '"') break;
+            if (c != '\\') {
+                if (out) out[length] = c;
+                length++;
+                continue;
+            }
+
+            if (pos_ >= text_.size()) throw std::runtime_error("Unterminated string");
+            char escaped = text_[pos_++];
+            if (escaped == 'u') {
+                uint32_t code = parseHex4();
+                if (code >= 0xD800 && code <= 0xDBFF) {
+                    if (peek() != '\\' || pos_ + 1 >= text_.size() || text_[pos_ + 1] != 'u') {
+                        throw std::runtime_error("Unpaired surrogate in string");
+                    }
+                    pos_ += 2;
+                    uint32_t low = parseHex4();
+                    if (low < 0xDC00 || low > 0xDFFF) throw std::runtime_error("Unpaired surrogate in string");
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                }
+                length += writeUtf8(code, out ? out + length : nullptr);
+                continue;
+            }
+
+            char decoded = '\0';
+            switch (escaped) {
+                case '"': decoded = '"'; break;
+                case '\\': decoded = '\\'; break;
+                case '/': decoded = '/'; break;
+                case 'b': decoded = '\b'; break;
+                case 'f': decoded = '\f'; break;
+                case 'n': decoded = '\n'; break;
+                case 'r': decoded = '\r'; break;
+                case 't': decoded = '\t'; break;
+                default: throw std::runtime_error("Invalid escape in string");
+            }
+            if (out) out[length] = decoded;
+            length++;
+        }
+        return length;
+    }
+
+    constexpr uint32_t parseHex4() {
+        if (pos_ + 4 > text_.size()) throw std::runtime_error("Invalid unicode escape");
+        uint32_t code = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            char c = text_[pos_++];
+            uint32_t digit = 0;
+            if (c >= '0' && c <= '9') digit = static_cast<uint32_t>(c - '0');
+            else if (c >= 'a' && c <= 'f') digit = static_cast<uint32_t>(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') digit = static_cast<uint32_t>(c - 'A' + 10);
+            else throw std::runtime_error("Invalid unicode escape");
+            code = code * 16 + digit;
+        }
+        return code;
+    }
+
+    static constexpr size_t writeUtf8(uint32_t code, char* out) {
+        char bytes[4] = {};
+        size_t count = 0;
+        if (code < 0x80) {
+            bytes[count++] = static_cast<char>(code);
+        } else if (code < 0x800) {
+            bytes[count++] = static_cast<char>(0xC0 | (code >> 6));
+            bytes[count++] = static_cast<char>(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            bytes[count++] = static_cast<char>(0xE0 | (code >> 12));
+            bytes[count++] = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            bytes[count++] = static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            bytes[count++] = static_cast<char>(0xF0 | (code >> 18));
+            bytes[count++] = static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            bytes[count++] = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            bytes[count++] = static_cast<char>(0x80 | (code & 0x3F));
+        }
+        for (size_t i = 0; out && i < count; ++i) {
+            out[i] = bytes[i];
+        }
+        return count;
+    }
+
+    // Parses a number or literal. Numbers are converted with correct
+    // rounding, so they equal what JsonParser produces for the same text.
+    constexpr void parseScalar(StaticNode* node = nullptr) {
+        char c = peek();
+        if (c == 't' || c == 'f' || c == 'n') {
+            std::string_view word = c == 't' ? "true" : (c == 'f' ? "false" : "null");
+            if (text_.substr(pos_, word.size()) != word) throw std::runtime_error("Invalid literal");
+            pos_ += word.size();
+            if (node) {
+                node->type = c == 'n' ? ValueType::NULL_TYPE : ValueType::BOOLEAN;
+                node->boolean = c == 't';
+            }
+            return;
+        }
+
+        bool negative = false;
+        if (c == '-') {
+            negative = true;
+            pos_++;
+        }
+        if (!isDigit(peek())) throw std::runtime_error("Invalid number");
+
+        size_t intStart = pos_;
+        if (peek() == '0') {
+            pos_++;
+            if (isDigit(peek())) throw std::runtime_error("Leading zero in number is not allowed");
+        } else {
+            while (isDigit(peek())) pos_++;
+        }
+        size_t intEnd = pos_;
+        size_t fracStart = pos_;
+        size_t fracEnd = pos_;
+        if (peek() == '.') {
+            pos_++;
+            if (!isDigit(peek())) throw std::runtime_error("Invalid number");
+            fracStart = pos_;
+            while (isDigit(peek())) pos_++;
+            fracEnd = pos_;
+        }
+        int exponent = 0;
+        if (peek() == 'e' || peek() == 'E') {
+            pos_++;
+            bool negativeExponent = false;
+            if (peek() == '+' || peek() == '-') negativeExponent = text_[pos_++] == '-';
+            if (!isDigit(peek())) throw std::runtime_error("Invalid number");
+            while (isDigit(peek())) {
+                if (exponent < 100000) exponent = exponent * 10 + (text_[pos_] - '0');
+                pos_++;
+            }
+            if (negativeExponent) exponent = -exponent;
+        }
+
+        if (node) {
+            node->type = ValueType::NUMBER;
+            node->number = toDouble(intStart, intEnd, fracStart, fracEnd, exponent);
+            if (negative) node->number = -node->number;
+        }
+    }
+
+    // Collects the significant digits into a big integer and converts
+    // digits * 10^exponent to the nearest double.
+    constexpr double toDouble(size_t intStart, size_t intEnd, size_t fracStart, size_t fracEnd, int exponent) const {
+        // Exact when the digits fit the mantissa and 10^|exponent| is exact.
+        // This covers nearly every literal without touching StaticBigInt,
+        // which keeps large documents within the constexpr evaluation limit.
+        uint64_t small = 0;
+        size_t smallCount = 0;
+        int smallExponent = exponent;
+        auto addSmall = [&](char c, bool fractional) {
+            if (smallCount == 0 && c == '0') {
+                if (fractional) smallExponent--;
+            } else if (smallCount < 19) {
+                small = small * 10 + static_cast<uint64_t>(c - '0');
+                smallCount++;
+                if (fractional) smallExponent--;
+            } else {
+                smallCount = 20;  // too long for the fast path
+            }
+        };
+        for (size_t i = intStart; i < intEnd; ++i) addSmall(text_[i], false);
+        for (size_t i = fracStart; i < fracEnd; ++i) addSmall(text_[i], true);
+        if (smallCount == 0) {
+            return 0.0;
+        }
+        if (smallCount <= 19 && small < (uint64_t(1) << 53) && smallExponent >= -22 && smallExponent <= 22) {
+            double value = static_cast<double>(small);
+            double power = 1.0;
+            for (int i = 0; i < (smallExponent < 0 ? -smallExponent : smallExponent); ++i) power *= 10.0;
+            return smallExponent < 0 ? value / power : value * power;
+        }
+
+        StaticBigInt digits;
+        size_t count = 0;
+        bool truncated = false;
+        auto addDigit = [&](char c, bool fractional) {
+            uint32_t digit = static_cast<uint32_t>(c - '0');
+            if (count == 0 && digit == 0) {
+                if (fractional) exponent--;
+            } else if (count < kMaxDigits) {
+                digits.multiplyAdd(10, digit);
+                count++;
+                if (fractional) exponent--;
+            } else {
+                truncated = truncated || digit != 0;
+                if (!fractional) exponent++;
+            }
+        };
+        for (size_t i = intStart; i < intEnd; ++i) addDigit(text_[i], false);
+        for (size_t i = fracStart; i < fracEnd; ++i) addDigit(text_[i], true);
+        if (truncated) {
+            // Stands in for the dropped digits: the value stays strictly
+            // between the same two halfway points.
+            digits.multiplyAdd(10, 1);
+            count++;
+            exponent--;
+        }
+
+        int magnitude = static_cast<int>(count) + exponent;  // value < 10^magnitude
+        if (magnitude > 310) throw std::runtime_error("Number out of range");
+        if (magnitude < -324) return 0.0;
+
+        if (exponent >= 0) {
+            digits.multiplyPow10(exponent);
+            size_t length = digits.bitLength();
+            size_t shift = length > 53 ? length - 53 : 0;
+            uint64_t mantissa = digits.bits(shift, length - shift);
+            if (shift > 0 && digits.bit(shift - 1) && (digits.anyBelow(shift - 1) || (mantissa & 1))) {
+                mantissa++;
+            }
+            return scaleByPowerOf2(mantissa, static_cast<int>(shift));
+        }
+
+        // digits / 10^-exponent: choose k so the quotient of digits * 2^k has
+        // 53 bits (fewer for subnormals), then round on the remainder.
+        StaticBigInt denominator;
+        denominator.multiplyAdd(1, 1);
+        denominator.multiplyPow10(-exponent);
+        int k = 53 + static_cast<int>(denominator.bitLength()) - static_cast<int>(digits.bitLength());
+        while (true) {
+            if (k > 1074) k = 1074;
+            StaticBigInt remainder = digits;
+            StaticBigInt divisor = denominator;
+            if (k >= 0) {
+                remainder.shiftLeft(static_cast<size_t>(k));
+            } else {
+                divisor.shiftLeft(static_cast<size_t>(-k));
+            }
+            uint64_t mantissa = remainder.divideSmallQuotient(divisor);
+            if (mantissa >= (uint64_t(1) << 53)) {
+                k--;
+                continue;
+            }
+            if (mantissa < (uint64_t(1) << 52) && k < 1074) {
+                k++;
+                continue;
+            }
+            remainder.shiftLeft(1);
+            int half = remainder.compare(divisor);
+            if (half > 0 || (half == 0 && (mantissa & 1))) {
+                mantissa++;
+            }
+            return scaleByPowerOf2(mantissa, -k);
+        }
+    }
+
+    // mantissa * 2^exponent, exact unless it overflows.
+    static constexpr double scaleByPowerOf2(uint64_t mantissa, int exponent) {
+        if (mantissa == (uint64_t(1) << 53)) {
+            mantissa >>= 1;
+            exponent++;
+        }
+        if (exponent + 53 > 1024) throw std::runtime_error("Number out of range");
+        double value = static_cast<double>(mantissa);
+        for (; exponent >= 60; exponent -= 60) value *= 1152921504606846976.0;          // 2^60
+        for (; exponent <= -60; exponent += 60) value /= 1152921504606846976.0;
+        for (; exponent > 0; --exponent) value *= 2.0;
+        for (; exponent < 0; ++exponent) value /= 2.0;
+        return value;
+    }
+
+    static constexpr bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+    constexpr std::string_view keyOf(size_t node) const {
+        return std::string_view(chars_ + nodes_[node].key, nodes_[node].keyLength);
+    }
+
+    // Orders by key, then by node index, which follows document order, so
+    // the last of several duplicate keys ends up last. Heap sort keeps this
+    // O(n log n) without scratch space, which matters inside constant
+    // evaluation.
+    constexpr bool memberBefore(size_t a, size_t b) const {
+        const char* left = chars_ + nodes_[a].key;
+        const char* right = chars_ + nodes_[b].key;
+        size_t leftLength = nodes_[a].keyLength;
+        size_t rightLength = nodes_[b].keyLength;
+        for (size_t i = 0; i < leftLength && i < rightLength; ++i) {
+            if (left[i] != right[i]) {
+                return static_cast<unsigned char>(left[i]) < static_cast<unsigned char>(right[i]);
+            }
+        }
+        return leftLength != rightLength ? leftLength < rightLength : a < b;
+    }
+
+    constexpr void siftDown(size_t* members, size_t root, size_t count) const {
+        while (true) {
+            size_t largest = root;
+            size_t left = 2 * root + 1;
+            size_t right = left + 1;
+            if (left < count && memberBefore(members[largest], members[left])) largest = left;
+            if (right < count && memberBefore(members[largest], members[right])) largest = right;
+            if (largest == root) return;
+            size_t swapped = members[root];
+            members[root] = members[largest];
+            members[largest] = swapped;
+            root = largest;
+        }
+    }
+
+    constexpr void sortMembers(size_t* members, size_t count) const {
+        for (size_t i = count / 2; i > 0; --i) {
+            siftDown(members, i - 1, count);
+        }
+        for (size_t end = count; end > 1; --end) {
+            size_t last = members[end - 1];
+            members[end - 1] = members[0];
+            members[0] = last;
+            siftDown(members, 0, end - 1);
+        }
+    }
+
+    // Builds the children table: each container's members are stored
+    // contiguously in document order, then object members are sorted by key
+    // with later duplicates replacing earlier ones, as in JsonValue.
+    constexpr void linkChildren() {
+        for (size_t i = 1; i < nodeCount_; ++i) {
+            nodes_[nodes_[i].parent].childCount++;
+        }
+        size_t offset = 0;
+        for (size_t i = 0; i < nodeCount_; ++i) {
+            nodes_[i].firstChild = offset;
+            offset += nodes_[i].childCount;
+            nodes_[i].childCount = 0;
+        }
+        for (size_t i = 1; i < nodeCount_; ++i) {
+            StaticNode& parent = nodes_[nodes_[i].parent];
+            children_[parent.firstChild + parent.childCount++] = i;
+        }
+
+        for (size_t i = 0; i < nodeCount_; ++i) {
+            StaticNode& object = nodes_[i];
+            if (object.type != ValueType::OBJECT) continue;
+            size_t* members = children_ + object.firstChild;
+            sortMembers(members, object.childCount);
+            size_t kept = 0;
+            for (size_t j = 0; j < object.childCount; ++j) {
+                if (kept > 0 && keyOf(members[kept - 1]) == keyOf(members[j])) {
+                    members[kept - 1] = members[j];
+                } else {
+                    members[kept++] = members[j];
+                }
+            }
+            object.childCount = kept;
+        }
+    }
+
+    // Enough significant digits to decide every halfway case (at most 767).
+    static constexpr size_t kMaxDigits = 800;
+
+    std::string_view text_;
+    size_t pos_;
+    StaticNode* nodes_ = nullptr;
+    size_t* children_ = nullptr;
+    char* chars_ = nullptr;
+    size_t nodeCapacity_ = 0;
+    size_t nodeCount_ = 0;
+    size_t charCount_ = 0;
+    size_t pendingKey_ = 0;
+    size_t pendingKeyLength_ = 0;
+};
+
+template <size_t Nodes, size_t Chars>
+constexpr StaticDocument<Nodes, Chars> buildStatic(std::string_view text) {
+    StaticDocument<Nodes, Chars> doc{};
+    StaticParser(text).build(doc);
+    return doc;
+}
+
+} // namespace detail
+
+// Parses the literal returned by `source` (a captureless lambda) at compile
+// time. Use the JSON_STATIC macro rather than calling this directly.
+template <typename Source>
+constexpr auto parseStatic(Source source) {
+    constexpr std::string_view text = source();
+    constexpr detail::StaticCounts counts = detail::StaticParser(text).measure();
+    return detail::buildStatic<counts.nodes, counts.chars>(text);
+}
+
+} // namespace json
+
+#define JSON_STATIC(literal) (::json::parseStatic([]() { return std::string_view(literal); }))
+
+#endif // JSON_STATIC_H
@@ -0,0 +1,98 @@
+#ifndef JSON_STATS_H
+#define JSON_STATS_H
+
+#include "JsonLexer.h"
+#include "JsonValue.h"
+#include <array>
+#include <chrono>
+#include <ostream>
+
+namespace json {
+
+constexpr size_t kTokenTypeCount = static_cast<size_t>(TokenType::INVALID) + 1;
+constexpr size_t kValueTypeCount = static_cast<size_t>(ValueType::OBJECT) + 1;
+
+// Counters collected by the lexer, parser and printer while stats are enabled.
+struct ParseStats {
+    std::chrono::nanoseconds lexTime{0};
+    std::chrono::nanoseconds parseTime{0};
+    std::chrono::nanoseconds printTime{0};
+    size_t bytesLexed = 0;
+    size_t bytesPrinted = 0;
+    std::array<size_t, kTokenTypeCount> tokens{};
+    std::array<size_t, kValueTypeCount> values{};
+    size_t allocations = 0;        // estimated heap allocations for document nodes and payloads
+    size_t maxDepth = 0;
+    size_t documentBytes = 0;      // estimated size of the document being built
+    size_t peakDocumentBytes = 0;
+    
+    // Folds in counters collected on another thread.
+    ParseStats& operator+=(const ParseStats& other);
+};
+
+// Library entry point for the instrumentation. Counters are thread-local, so
+// each worker thread reports on its own documents. Every hook is guarded by
+// JSON_STATS_ACTIVE(), and current() is only called once it returned true.
+// Without JSON_ENABLE_STATS that guard is a constant false, the optimizer
+// drops the hooks, and setEnabled() is a no-op.
+class Stats {
+public:
+    static bool compiledIn();
+    static void setEnabled(bool enabled);
+    static bool enabled();
+
+    static ParseStats& current();
+    static void reset();
+
+    static void report(std::ostream& out, const ParseStats& stats);
+    static void report(std::ostream& out) { report(out, current()); }
+
+    static const char* tokenTypeName(TokenType type);
+    static const char* valueTypeName(ValueType type);
+};
+
+// Adds the elapsed time of a scope to one of the current thread's ParseStats
+// durations. Time recorded meanwhile under `excluded` is subtracted, so a
+// phase that runs nested inside another (lexing on demand while parsing) is
+// not counted twice. Neither the clock nor the counters are touched unless
+// `active`.
+class StatsTimer {
+public:
+    StatsTimer(std::chrono::nanoseconds ParseStats::*slot, bool active,
+               std::chrono::nanoseconds ParseStats::*excluded = nullptr)
+        : slot_(nullptr), excluded_(nullptr) {
+        if (!active) return;
+        ParseStats& stats = Stats::current();
+        slot_ = &(stats.*slot);
+        if (excluded) {
+            excluded_ = &(stats.*excluded);
+            excludedAtStart_ = *excluded_;
+        }
+        start_ = std::chrono::steady_clock::now();
+    }
+    ~StatsTimer() {
+        if (!slot_) return;
+        std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start_;
+        if (excluded_) elapsed -= *excluded_ - excludedAtStart_;
+        *slot_ += elapsed;
+    }
+
+    StatsTimer(const StatsTimer&) = delete;
+    StatsTimer& operator=(const StatsTimer&) = delete;
+
+private:
+    std::chrono::nanoseconds* slot_;
+    std::chrono::nanoseconds* excluded_;
+    std::chrono::nanoseconds excludedAtStart_{0};
+    std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace json
+
+#ifdef JSON_ENABLE_STATS
+#define JSON_STATS_ACTIVE() (::json::Stats::enabled())
+#else
+#define JSON_STATS_ACTIVE() false
+#endif
+
+#endif // JSON_STATS_H
@@ -9,6 +9,12 @@
 
 namespace json {
 
+class JsonValue;
+
+namespace detail {
+struct JsonValueAccess;
+}
+
 enum class ValueType {
     NULL_TYPE,
     BOOLEAN,
@@ -26,6 +32,16 @@ public:
     explicit JsonValue(const std::string& value);
     explicit JsonValue(const char* value);
     
+    // Copies share array/object payloads and are O(1); the payload is cloned
+    // one level at a time when a shared copy is first mutated. Copies may be
+    // mutated and destroyed on different threads; one JsonValue object may
+    // only be shared between threads for reading.
+    JsonValue(const JsonValue& other);
+    JsonValue(JsonValue&& other) = default;
+    JsonValue& operator=(const JsonValue& other);
+    JsonValue& operator=(JsonValue&& other) = default;
+    ~JsonValue();
+    
     static JsonValue makeNull();
     static JsonValue makeArray();
     static JsonValue makeObject();
@@ -51,20 +67,60 @@ public:
     const JsonValue& operator[](const std::string& key) const;
     
     void push_back(const JsonValue& value);
+    void push_back(JsonValue&& value);
+    void set(const std::string& key, JsonValue&& value);
     bool hasKey(const std::string& key) const;
     
+    // In-place editing that moves payloads instead of copying them.
+    JsonValue* find(const std::string& key);
+    const JsonValue* find(const std::string& key) const;
+    void insert(size_t index, JsonValue&& value);
+    JsonValue erase(size_t index);
+    JsonValue erase(const std::string& key);
+    
     const std::vector<JsonValue>& getArray() const;
     const std::map<std::string, JsonValue>& getObject() const;
     
+    bool operator==(const JsonValue& other) const;
+    bool operator!=(const JsonValue& other) const { return !(*this == other); }
+    
 private:
+    friend struct detail::JsonValueAccess;
+    
+    using Array = std::vector<JsonValue>;
+    using Object = std::map<std::string, JsonValue>;
+    
+    Array& mutableArray(bool leak);
+    Object& mutableObject(bool leak);
+    void shareFrom(const JsonValue& other);
+    static void clonePayloads(JsonValue& target, const JsonValue& source);
+    bool ownsNestedChildren() const;
+    void detachNestedChildren(std::vector<JsonValue>& pending);
+    
     ValueType type_;
     bool boolValue_;
+    // Set once a mutable reference into the payload has been handed out;
+    // copies of a leaked value clone the payload instead of sharing it.
+    bool leaked_;
     double numberValue_;
     std::string stringValue_;
-    std::vector<JsonValue> arrayValue_;
-    std::map<std::string, JsonValue> objectValue_;
+    // Immutable while shared; null means empty.
+    std::shared_ptr<Array> arrayValue_;
+    std::shared_ptr<Object> objectValue_;
+};
+
+namespace detail {
+
+// Mutable access for library code that never keeps the returned reference
+// beyond the current operation. Unlike the public accessors it does not mark
+// the value as leaked, so later copies keep sharing its payload.
+struct JsonValueAccess {
+    static JsonValue* find(JsonValue& value, const std::string& key);
+    static JsonValue& at(JsonValue& value, size_t index);
 };
 
+} // namespace detail
+
 } // namespace json
 
 #endif // JSON_VALUE_H
@@ -0,0 +1,266 @@
+#include "JsonBatch.h"
+#include "JsonSchema.h"
+#include "JsonStats.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace json {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+struct LoadedFile {
+    size_t index;
+    bool ok;
+    std::string content;
+    std::string error;
+};
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file: " + path);
+    }
+    file.seekg(0, std::ios::end);
+    std::streamoff size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    if (size < 0) {
+        throw std::runtime_error("Could not read file: " + path);
+    }
+
+    std::string content(static_cast<size_t>(size), '\0');
+    if (!file.read(&content[0], size)) {
+        throw std::runtime_error("Could not read file: " + path);
+    }
+    return content;
+}
+
+// State shared by the reader, the parser threads and the calling thread.
+// `emitted` counts results handed to the caller; the reader never gets more
+// than `window` files ahead of it, which bounds memory in both output modes.
+class Pipeline {
+public:
+    Pipeline(const std::vector<BatchInput>& inputs, const JsonBatch::Task& task,
+             const BatchOptions& options, size_t window)
+        : inputs_(inputs), task_(task), options_(options), window_(window) {}
+
+    void read() {
+        for (size_t i = 0; i < inputs_.size(); ++i) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                readCv_.wait(lock, [&]() { return aborted_ || i < emitted_ + window_; });
+                if (aborted_) break;
+            }
+
+            LoadedFile file{i, true, "", ""};
+            try {
+                file.content = readFile(inputs_[i].path);
+            } catch (const std::exception& e) {
+                file.ok = false;
+                file.error = e.what();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                loaded_.push_back(std::move(file));
+            }
+            workCv_.notify_one();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        readerDone_ = true;
+        workCv_.notify_all();
+    }
+
+    void work() {
+        while (true) {
+            LoadedFile file;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                workCv_.wait(lock, [&]() { return !loaded_.empty() || readerDone_ || aborted_; });
+                if (aborted_ || loaded_.empty()) break;
+                file = std::move(loaded_.front());
+                loaded_.pop_front();
+            }
+
+            BatchResult result{file.index, &inputs_[file.index], false, "", file.error};
+            if (file.ok) {
+                try {
+                    if (options_.validateOnly && options_.schema) {
+                        options_.schema->validateStream(file.content, options_.parse);
+                    } else if (options_.validateOnly) {
+                        JsonParser(file.content, options_.parse).parse();
+                    } else {
+                        JsonValue value = options_.schema ? options_.schema->parse(file.content, options_.parse)
+                                                          : JsonParser(file.content, options_.parse).parse();
+                        result.output = task_(value);
+                    }
+                    result.ok = true;
+                } catch (const std::exception& e) {
+                    result.error = e.what();
+                }
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                finished_.emplace(result.index, std::move(result));
+            }
+            doneCv_.notify_one();
+        }
+
+        if (JSON_STATS_ACTIVE()) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            workerStats_ += Stats::current();
+        }
+    }
+
+    size_t deliver(const JsonBatch::ResultHandler& onResult) {
+        size_t failures = 0;
+        std::vector<BatchResult> ready;
+
+        while (true) {
+            ready.clear();
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                if (emitted_ == inputs_.size()) break;
+                doneCv_.wait(lock, [&]() {
+                    return options_.ordered ? finished_.count(emitted_) > 0 : !finished_.empty();
+                });
+
+                if (options_.ordered) {
+                    for (auto it = finished_.find(emitted_ + ready.size());
+                         it != finished_.end() && it->first == emitted_ + ready.size();
+                         it = finished_.erase(it)) {
+                        ready.push_back(std::move(it->second));
+                    }
+                } else {
+                    for (auto& pair : finished_) {
+                        ready.push_back(std::move(pair.second));
+                    }
+                    finished_.clear();
+                }
+            }
+
+            for (const auto& result : ready) {
+                if (!result.ok) failures++;
+                onResult(result);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                emitted_ += ready.size();
+            }
+            readCv_.notify_one();
+        }
+        return failures;
+    }
+
+    void abort() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        aborted_ = true;
+        readCv_.notify_all();
+        workCv_.notify_all();
+    }
+
+    const ParseStats& workerStats() const { return workerStats_; }
+
+private:
+    const std::vector<BatchInput>& inputs_;
+    const JsonBatch::Task& task_;
+    const BatchOptions& options_;
+    size_t window_;
+
+    std::mutex mutex_;
+    std::condition_variable readCv_;
+    std::condition_variable workCv_;
+    std::condition_variable doneCv_;
+    std::deque<LoadedFile> loaded_;
+    std::map<size_t, BatchResult> finished_;
+    size_t emitted_ = 0;
+    bool readerDone_ = false;
+    bool aborted_ = false;
+    ParseStats workerStats_;
+};
+
+} // namespace
+
+std::vector<BatchInput> JsonBatch::collectInputs(const std::vector<std::string>& paths) {
+    std::vector<BatchInput> inputs;
+    for (const auto& path : paths) {
+        std::error_code ec;
+        if (!fs::is_directory(path, ec)) {
+            inputs.push_back(BatchInput{path, fs::path(path).filename().string()});
+            continue;
+        }
+
+        std::vector<BatchInput> found;
+        for (const auto& entry : fs::recursive_directory_iterator(path)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".json") {
+                found.push_back(BatchInput{entry.path().string(),
+                                           fs::relative(entry.path(), path).generic_string()});
+            }
+        }
+        std::sort(found.begin(), found.end(),
+                  [](const BatchInput& a, const BatchInput& b) { return a.path < b.path; });
+        inputs.insert(inputs.end(), found.begin(), found.end());
+    }
+    return inputs;
+}
+
+void JsonBatch::requireDistinctNames(const std::vector<BatchInput>& inputs) {
+    std::map<std::string, const BatchInput*> seen;
+    for (const auto& input : inputs) {
+        auto [it, added] = seen.emplace(input.name, &input);
+        if (!added) {
+            throw std::runtime_error("'" + it->second->path + "' and '" + input.path +
+                                     "' would both be written to '" + input.name + "' in the output directory");
+        }
+    }
+}
+
+size_t JsonBatch::run(const std::vector<BatchInput>& inputs, const Task& task,
+                      const ResultHandler& onResult, const BatchOptions& options) {
+    if (inputs.empty()) {
+        return 0;
+    }
+
+    size_t jobs = options.jobs != 0 ? options.jobs : std::max(1u, std::thread::hardware_concurrency());
+    jobs = std::min(jobs, inputs.size());
+    size_t readAhead = options.readAhead != 0 ? options.readAhead : 2 * jobs;
+
+    Pipeline pipeline(inputs, task, options, readAhead + jobs);
+    std::thread reader(&Pipeline::read, &pipeline);
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < jobs; ++i) {
+        workers.emplace_back(&Pipeline::work, &pipeline);
+    }
+
+    size_t failures = 0;
+    try {
+        failures = pipeline.deliver(onResult);
+    } catch (...) {
+        pipeline.abort();
+        reader.join();
+        for (auto& worker : workers) worker.join();
+        throw;
+    }
+
+    reader.join();
+    for (auto& worker : workers) worker.join();
+
+    // Worker threads collect their own counters; fold them into the caller's.
+    if (JSON_STATS_ACTIVE()) {
+        Stats::current() += pipeline.workerStats();
+    }
+    return failures;
+}
+
+} // namespace json
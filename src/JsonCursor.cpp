@@ -0,0 +1,98 @@
+#include "JsonCursor.h"
+#include "JsonStats.h"
+#include <fstream>
+#include <stdexcept>
+
+namespace json {
+
+JsonCursor::JsonCursor(const std::string& filename, const ParseOptions& options)
+    : file_(std::make_unique<std::ifstream>(filename, std::ios::binary)), state_(State::Start), index_(0) {
+    if (!static_cast<std::ifstream&>(*file_).is_open()) {
+        throw std::runtime_error("Could not open file: " + filename);
+    }
+    parser_ = std::make_unique<JsonParser>(*file_, options);
+}
+
+JsonCursor::JsonCursor(std::istream& input, const ParseOptions& options)
+    : parser_(std::make_unique<JsonParser>(input, options)), state_(State::Start), index_(0) {}
+
+JsonCursor::~JsonCursor() = default;
+
+bool JsonCursor::next() {
+    switch (state_) {
+        case State::Start:
+            // The array itself is depth 1, as in JsonParser; elements nest below it.
+            parser_->enterContainer(1, parser_->peek());
+            parser_->expect(TokenType::LEFT_BRACKET, "Expected '[' at start of array");
+            if (parser_->match(TokenType::RIGHT_BRACKET)) {
+                finish();
+                return false;
+            }
+            break;
+
+        case State::AtElement:
+            skip();
+            [[fallthrough]];
+
+        case State::AfterElement:
+            if (!parser_->match(TokenType::COMMA)) {
+                parser_->expect(TokenType::RIGHT_BRACKET, "Expected ']'");
+                finish();
+                return false;
+            }
+            index_++;
+            break;
+
+        case State::Done:
+            return false;
+    }
+
+    // Each element starts with a fresh token window and memory estimate.
+    parser_->discardConsumedTokens();
+    if (parser_->collectStats_) {
+        Stats::current().documentBytes = 0;
+    }
+    state_ = State::AtElement;
+    return true;
+}
+
+JsonValue JsonCursor::readValue() {
+    requireElement("read");
+    StatsTimer timer(&ParseStats::parseTime, parser_->collectStats_, &ParseStats::lexTime);
+    JsonValue value = parser_->parseValue(1);
+    state_ = State::AfterElement;
+    return value;
+}
+
+bool JsonCursor::isArray() {
+    return state_ != State::Start || parser_->peek().type == TokenType::LEFT_BRACKET;
+}
+
+JsonValue JsonCursor::readDocument() {
+    if (state_ != State::Start) {
+        throw std::runtime_error("Cannot read the whole document after next()");
+    }
+    state_ = State::Done;
+    return parser_->parse();
+}
+
+void JsonCursor::skip() {
+    requireElement("skip");
+    StatsTimer timer(&ParseStats::parseTime, parser_->collectStats_, &ParseStats::lexTime);
+    parser_->skipValue(1);
+    state_ = State::AfterElement;
+}
+
+// The closing ']' must end the document, as for JsonParser::parse().
+void JsonCursor::finish() {
+    parser_->expectEndOfInput();
+    state_ = State::Done;
+}
+
+void JsonCursor::requireElement(const char* action) const {
+    if (state_ != State::AtElement) {
+        throw std::runtime_error(std::string("No array element to ") + action + "; call next() first");
+    }
+}
+
+} // namespace json
@@ -0,0 +1,501 @@
+#include "JsonDiff.h"
+#include "JsonPointer.h"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace json {
+
+namespace {
+
+// The two lanes use different finalizers, string hashes and seeds, so a
+// collision in one lane says nothing about the other.
+uint64_t mixLow(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+uint64_t mixHigh(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+SubtreeHash mix(uint64_t x) {
+    return SubtreeHash{mixLow(x), mixHigh(x ^ 0x6a09e667f3bcc909ULL)};
+}
+
+SubtreeHash combine(SubtreeHash seed, SubtreeHash value) {
+    return SubtreeHash{
+        mixLow(seed.low ^ (value.low + 0x9e3779b97f4a7c15ULL + (seed.low << 6) + (seed.low >> 2))),
+        mixHigh(seed.high ^ (value.high + 0xbb67ae8584caa73bULL + (seed.high << 7) + (seed.high >> 3)))};
+}
+
+SubtreeHash combine(SubtreeHash seed, uint64_t value) {
+    return combine(seed, mix(value));
+}
+
+SubtreeHash hashString(const std::string& str) {
+    uint64_t fnv = 0xcbf29ce484222325ULL;
+    uint64_t poly = str.size();
+    for (char c : str) {
+        fnv ^= static_cast<unsigned char>(c);
+        fnv *= 0x100000001b3ULL;
+        poly = (poly + static_cast<unsigned char>(c) + 1) * 0x9e3779b97f4a7c15ULL;
+    }
+    return SubtreeHash{mixLow(fnv), mixHigh(poly)};
+}
+
+SubtreeHash hashScalar(const JsonValue& value) {
+    SubtreeHash tag = mix(static_cast<uint64_t>(value.getType()) + 1);
+    switch (value.getType()) {
+        case ValueType::BOOLEAN:
+            return combine(tag, value.asBool() ? 1 : 0);
+        case ValueType::NUMBER: {
+            double number = value.asNumber();
+            if (number == 0.0) {
+                number = 0.0; // -0.0 compares equal to 0.0
+            }
+            uint64_t bits;
+            std::memcpy(&bits, &number, sizeof(bits));
+            return combine(tag, bits);
+        }
+        case ValueType::STRING:
+            return combine(tag, hashString(value.asString()));
+        default:
+            return tag;
+    }
+}
+
+// Hashes a container from the already computed hashes of its members.
+template <typename Lookup>
+SubtreeHash hashContainer(const JsonValue& value, Lookup lookup) {
+    SubtreeHash h = mix(static_cast<uint64_t>(value.getType()) + 1);
+    if (value.isArray()) {
+        for (const auto& element : value.getArray()) {
+            h = combine(h, lookup(element));
+        }
+    } else {
+        for (const auto& pair : value.getObject()) {
+            h = combine(h, combine(hashString(pair.first), lookup(pair.second)));
+        }
+    }
+    return combine(h, value.size());
+}
+
+bool isContainer(const JsonValue& value) {
+    return value.isArray() || value.isObject();
+}
+
+size_t slotIndex(const JsonValue* value, size_t mask) {
+    return static_cast<size_t>(mixLow(reinterpret_cast<uintptr_t>(value))) & mask;
+}
+
+struct DiffTask;
+
+// Either a patch operation or a nested comparison whose operations belong
+// at this point in the output. An operation targets the task's own value,
+// or its member `token` when `onMember` is set.
+struct Piece {
+    const char* op;
+    bool onMember;
+    std::string token;
+    const JsonValue* value;
+    DiffTask* child;
+};
+
+// A task only knows its own pointer token; full paths are assembled while
+// the finished task tree is flattened, so deep documents cost linear space.
+struct DiffTask {
+    const JsonValue* from;
+    const JsonValue* to;
+    std::string token;
+    std::vector<Piece> pieces;
+};
+
+JsonValue makeOp(const char* name, const std::string& path, const JsonValue* value) {
+    JsonValue op = JsonValue::makeObject();
+    op.set("op", JsonValue(name));
+    op.set("path", JsonValue(path));
+    if (value) {
+        op.set("value", JsonValue(*value));
+    }
+    return op;
+}
+
+// Expands comparison tasks without recursion. Tasks live in a deque so that
+// pointers to them stay valid while new ones are spawned. The worker that
+// owns the root may hand the children of a large container to helper
+// workers running on their own threads.
+class DiffWorker {
+public:
+    DiffWorker(const SubtreeHashes& fromHashes, const SubtreeHashes& toHashes,
+               const DiffOptions& options, unsigned threads)
+        : fromHashes_(fromHashes), toHashes_(toHashes), options_(options), threads_(threads) {}
+
+    DiffTask* spawn(const JsonValue* from, const JsonValue* to, std::string token) {
+        tasks_.push_back(DiffTask{from, to, std::move(token), {}});
+        return &tasks_.back();
+    }
+
+    void run(DiffTask* root) {
+        std::vector<DiffTask*> stack{root};
+        std::vector<DiffTask*> children;
+        while (!stack.empty()) {
+            DiffTask* task = stack.back();
+            stack.pop_back();
+
+            children.clear();
+            expand(*task, children);
+            if (threads_ > 1 && children.size() >= options_.parallelThreshold) {
+                fanOut(children);
+            } else {
+                stack.insert(stack.end(), children.begin(), children.end());
+            }
+        }
+    }
+
+private:
+    void expand(DiffTask& task, std::vector<DiffTask*>& children) {
+        const JsonValue& a = *task.from;
+        const JsonValue& b = *task.to;
+        if (same(a, b)) {
+            return;
+        }
+        if (a.getType() != b.getType() || !isContainer(a)) {
+            task.pieces.push_back(Piece{"replace", false, std::string(), &b, nullptr});
+            return;
+        }
+        if (a.isObject()) {
+            diffObjects(task, children);
+        } else {
+            diffArrays(task, children);
+        }
+    }
+
+    void addOp(DiffTask& task, const char* op, std::string token, const JsonValue* value) {
+        task.pieces.push_back(Piece{op, true, std::move(token), value, nullptr});
+    }
+
+    void addChild(DiffTask& task, const JsonValue& a, const JsonValue& b, std::string token,
+                  std::vector<DiffTask*>& children) {
+        DiffTask* child = spawn(&a, &b, std::move(token));
+        task.pieces.push_back(Piece{nullptr, false, std::string(), nullptr, child});
+        children.push_back(child);
+    }
+
+    bool same(const JsonValue& a, const JsonValue& b) const {
+        return fromHashes_.get(a) == toHashes_.get(b);
+    }
+
+    void diffObjects(DiffTask& task, std::vector<DiffTask*>& children) {
+        const auto& from = task.from->getObject();
+        const auto& to = task.to->getObject();
+        auto a = from.begin();
+        auto b = to.begin();
+
+        // Both maps are sorted by key, so a single merge pass pairs them up.
+        while (a != from.end() || b != to.end()) {
+            if (b == to.end() || (a != from.end() && a->first < b->first)) {
+                addOp(task, "remove", escapePointerToken(a->first), nullptr);
+                ++a;
+            } else if (a == from.end() || b->first < a->first) {
+                addOp(task, "add", escapePointerToken(b->first), &b->second);
+                ++b;
+            } else {
+                if (!same(a->second, b->second)) {
+                    addChild(task, a->second, b->second, escapePointerToken(a->first), children);
+                }
+                ++a;
+                ++b;
+            }
+        }
+    }
+
+    void diffArrays(DiffTask& task, std::vector<DiffTask*>& children) {
+        const auto& from = task.from->getArray();
+        const auto& to = task.to->getArray();
+        size_t n = from.size();
+        size_t m = to.size();
+
+        std::vector<SubtreeHash> ha(n);
+        std::vector<SubtreeHash> hb(m);
+        for (size_t i = 0; i < n; ++i) ha[i] = fromHashes_.get(from[i]);
+        for (size_t j = 0; j < m; ++j) hb[j] = toHashes_.get(to[j]);
+
+        // Unchanged prefix and suffix need no operations.
+        size_t prefix = 0;
+        while (prefix < n && prefix < m && ha[prefix] == hb[prefix]) {
+            ++prefix;
+        }
+        size_t suffix = 0;
+        while (suffix < n - prefix && suffix < m - prefix && ha[n - 1 - suffix] == hb[m - 1 - suffix]) {
+            ++suffix;
+        }
+
+        size_t na = n - prefix - suffix;
+        size_t nb = m - prefix - suffix;
+        std::vector<char> script = alignElements(ha, hb, prefix, na, nb);
+
+        // Replay the edit script left to right, tracking where each operation
+        // lands in the partially patched array.
+        size_t pos = prefix;
+        size_t ai = prefix;
+        size_t bj = prefix;
+        size_t k = 0;
+        while (k < script.size()) {
+            if (script[k] == 'K') {
+                ++pos; ++ai; ++bj; ++k;
+                continue;
+            }
+
+            size_t removed = 0;
+            size_t added = 0;
+            for (; k < script.size() && script[k] != 'K'; ++k) {
+                if (script[k] == 'D') ++removed; else ++added;
+            }
+
+            size_t changed = std::min(removed, added);
+            for (size_t c = 0; c < changed; ++c) {
+                addChild(task, from[ai++], to[bj++], std::to_string(pos++), children);
+            }
+            for (size_t r = changed; r < removed; ++r) {
+                addOp(task, "remove", std::to_string(pos), nullptr);
+                ++ai;
+            }
+            for (size_t i = changed; i < added; ++i) {
+                addOp(task, "add", std::to_string(pos++), &to[bj++]);
+            }
+        }
+    }
+
+    // Edit script over the middle section of two arrays: 'K' keeps an
+    // element, 'D' deletes one from `from`, 'I' inserts one from `to`.
+    // Elements are matched by subtree hash with an LCS alignment when the
+    // table is small enough, and positionally otherwise.
+    std::vector<char> alignElements(const std::vector<SubtreeHash>& ha, const std::vector<SubtreeHash>& hb,
+                                    size_t offset, size_t na, size_t nb) const {
+        std::vector<char> script;
+        script.reserve(na + nb);
+
+        if (na == nb || (na + 1) * (nb + 1) > options_.maxLcsCells) {
+            size_t common = std::min(na, nb);
+            for (size_t i = 0; i < common; ++i) {
+                if (ha[offset + i] == hb[offset + i]) {
+                    script.push_back('K');
+                } else {
+                    script.push_back('D');
+                    script.push_back('I');
+                }
+            }
+            script.insert(script.end(), na - common, 'D');
+            script.insert(script.end(), nb - common, 'I');
+            return script;
+        }
+
+        // lcs[i * width + j] is the LCS length of the suffixes starting at i and j.
+        size_t width = nb + 1;
+        std::vector<uint32_t> lcs((na + 1) * width, 0);
+        for (size_t i = na; i-- > 0;) {
+            for (size_t j = nb; j-- > 0;) {
+                if (ha[offset + i] == hb[offset + j]) {
+                    lcs[i * width + j] = lcs[(i + 1) * width + j + 1] + 1;
+                } else {
+                    lcs[i * width + j] = std::max(lcs[(i + 1) * width + j], lcs[i * width + j + 1]);
+                }
+            }
+        }
+
+        size_t i = 0;
+        size_t j = 0;
+        while (i < na && j < nb) {
+            if (ha[offset + i] == hb[offset + j]) {
+                script.push_back('K');
+                ++i; ++j;
+            } else if (lcs[(i + 1) * width + j] >= lcs[i * width + j + 1]) {
+                script.push_back('D');
+                ++i;
+            } else {
+                script.push_back('I');
+                ++j;
+            }
+        }
+        script.insert(script.end(), na - i, 'D');
+        script.insert(script.end(), nb - j, 'I');
+        return script;
+    }
+
+    void fanOut(const std::vector<DiffTask*>& children) {
+        size_t count = std::min<size_t>(threads_, children.size());
+        size_t first = helpers_.size();
+        for (size_t t = 0; t < count; ++t) {
+            helpers_.push_back(std::make_unique<DiffWorker>(fromHashes_, toHashes_, options_, 1));
+        }
+
+        std::vector<std::exception_ptr> errors(count);
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < count; ++t) {
+            threads.emplace_back([&, t]() {
+                try {
+                    for (size_t k = t; k < children.size(); k += count) {
+                        helpers_[first + t]->run(children[k]);
+                    }
+                } catch (...) {
+                    errors[t] = std::current_exception();
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        for (const auto& error : errors) {
+            if (error) std::rethrow_exception(error);
+        }
+    }
+
+    const SubtreeHashes& fromHashes_;
+    const SubtreeHashes& toHashes_;
+    const DiffOptions& options_;
+    unsigned threads_;
+    std::deque<DiffTask> tasks_;
+    std::vector<std::unique_ptr<DiffWorker>> helpers_;
+};
+
+} // namespace
+
+SubtreeHashes::SubtreeHashes(const JsonValue& root) {
+    if (!isContainer(root)) {
+        return;
+    }
+
+    // Post-order walk: a container is hashed once all of its members are.
+    std::vector<std::pair<const JsonValue*, bool>> stack;
+    stack.emplace_back(&root, false);
+
+    while (!stack.empty()) {
+        auto [value, expanded] = stack.back();
+        if (!expanded) {
+            stack.back().second = true;
+            if (value->isArray()) {
+                for (const auto& element : value->getArray()) {
+                    if (isContainer(element)) stack.emplace_back(&element, false);
+                }
+            } else {
+                for (const auto& pair : value->getObject()) {
+                    if (isContainer(pair.second)) stack.emplace_back(&pair.second, false);
+                }
+            }
+        } else {
+            insert(value, hashContainer(*value, [this](const JsonValue& member) { return get(member); }));
+            stack.pop_back();
+        }
+    }
+}
+
+void SubtreeHashes::insert(const JsonValue* value, SubtreeHash hash) {
+    if ((count_ + 1) * 2 > slots_.size()) {
+        std::vector<Slot> old(std::max<size_t>(64, slots_.size() * 2));
+        old.swap(slots_);
+        for (const Slot& slot : old) {
+            if (slot.value) place(slot);
+        }
+    }
+    place(Slot{value, hash});
+    count_++;
+}
+
+void SubtreeHashes::place(const Slot& slot) {
+    size_t mask = slots_.size() - 1;
+    size_t i = slotIndex(slot.value, mask);
+    while (slots_[i].value) {
+        i = (i + 1) & mask;
+    }
+    slots_[i] = slot;
+}
+
+SubtreeHash SubtreeHashes::get(const JsonValue& value) const {
+    if (!isContainer(value)) {
+        return hashScalar(value);
+    }
+    if (!slots_.empty()) {
+        size_t mask = slots_.size() - 1;
+        for (size_t i = slotIndex(&value, mask); slots_[i].value; i = (i + 1) & mask) {
+            if (slots_[i].value == &value) return slots_[i].hash;
+        }
+    }
+    throw std::out_of_range("Value is not part of the hashed document");
+}
+
+JsonValue JsonDiff::diff(const JsonValue& from, const JsonValue& to, const DiffOptions& options) {
+    unsigned threads = options.threads != 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+
+    // Hash both documents, concurrently when more than one thread is allowed.
+    std::unique_ptr<SubtreeHashes> fromHashes;
+    std::unique_ptr<SubtreeHashes> toHashes;
+    if (threads > 1) {
+        std::exception_ptr error;
+        std::thread worker([&]() {
+            try {
+                fromHashes = std::make_unique<SubtreeHashes>(from);
+            } catch (...) {
+                error = std::current_exception();
+            }
+        });
+        toHashes = std::make_unique<SubtreeHashes>(to);
+        worker.join();
+        if (error) std::rethrow_exception(error);
+    } else {
+        fromHashes = std::make_unique<SubtreeHashes>(from);
+        toHashes = std::make_unique<SubtreeHashes>(to);
+    }
+
+    DiffWorker worker(*fromHashes, *toHashes, options, threads);
+    DiffTask* root = worker.spawn(&from, &to, "");
+    worker.run(root);
+
+    // Flatten the task tree into the patch, preserving operation order. The
+    // pointer of the current task is extended and truncated along the way.
+    JsonValue patch = JsonValue::makeArray();
+    std::string path;
+    std::vector<std::pair<DiffTask*, size_t>> stack;
+    stack.emplace_back(root, 0);
+    while (!stack.empty()) {
+        DiffTask* task = stack.back().first;
+        size_t index = stack.back().second;
+        if (index == task->pieces.size()) {
+            path.resize(path.size() - (task == root ? 0 : task->token.size() + 1));
+            stack.pop_back();
+            continue;
+        }
+        stack.back().second++;
+
+        const Piece& piece = task->pieces[index];
+        if (piece.child) {
+            path += '/';
+            path += piece.child->token;
+            stack.emplace_back(piece.child, 0);
+        } else if (piece.onMember) {
+            patch.push_back(makeOp(piece.op, path + "/" + piece.token, piece.value));
+        } else {
+            patch.push_back(makeOp(piece.op, path, piece.value));
+        }
+    }
+    return patch;
+}
+
+SubtreeHash JsonDiff::hash(const JsonValue& value) {
+    return SubtreeHashes(value).get(value);
+}
+
+} // namespace json
@@ -1,31 +1,114 @@
 #include "JsonLexer.h"
+#include "JsonStats.h"
 #include <cctype>
+#include <istream>
 #include <stdexcept>
 
 namespace json {
 
-JsonLexer::JsonLexer(const std::string& input)
-    : input_(input), current_(0), line_(1), column_(1) {}
+namespace {
+
+// Bytes pulled from a stream per refill.
+constexpr size_t kStreamChunkSize = 64 * 1024;
+
+// Tokens scanned per call to scanBatch(). Timing a batch instead of each
+// token keeps clock reads out of the per-token cost.
+constexpr size_t kTokenBatchSize = 256;
+
+} // namespace
+
+JsonLexer::JsonLexer(const std::string& input, size_t maxDepth)
+    : input_(input), current_(0), line_(1), column_(1), maxDepth_(maxDepth), stream_(nullptr), pendingIndex_(0) {}
+
+JsonLexer::JsonLexer(std::istream& input, size_t maxDepth)
+    : current_(0), line_(1), column_(1), maxDepth_(maxDepth), stream_(&input), pendingIndex_(0) {}
+
+Token JsonLexer::next() {
+    if (pendingIndex_ == pending_.size()) {
+        scanBatch();
+    }
+    Token token = std::move(pending_[pendingIndex_++]);
+    if (JSON_STATS_ACTIVE()) {
+        Stats::current().tokens[static_cast<size_t>(token.type)]++;
+    }
+    return token;
+}
+
+void JsonLexer::scanBatch() {
+    if (pendingError_) {
+        std::rethrow_exception(pendingError_);
+    }
+    pending_.clear();
+    pendingIndex_ = 0;
+    
+    StatsTimer timer(&ParseStats::lexTime, JSON_STATS_ACTIVE());
+    try {
+        while (pending_.size() < kTokenBatchSize) {
+            pending_.push_back(scanToken());
+            if (pending_.back().type == TokenType::END_OF_FILE) {
+                break;
+            }
+        }
+    } catch (const std::exception&) {
+        if (pending_.empty()) {
+            throw;
+        }
+        pendingError_ = std::current_exception();
+    }
+}
 
 std::vector<Token> JsonLexer::tokenize() {
+    const bool collectStats = JSON_STATS_ACTIVE();
+    ParseStats* stats = collectStats ? &Stats::current() : nullptr;
+    StatsTimer timer(&ParseStats::lexTime, collectStats);
+    
     std::vector<Token> tokens;
+    size_t depth = 0;
     
-    while (!isAtEnd()) {
-        skipWhitespace();
-        if (isAtEnd()) break;
-        
-        Token token = nextToken();
-        if (token.type == TokenType::INVALID) {
-            throw std::runtime_error("Invalid token at line " + std::to_string(line_) + 
-                                   ", column " + std::to_string(column_));
+    while (true) {
+        Token token = scanToken();
+        if (token.type == TokenType::END_OF_FILE) {
+            tokens.push_back(std::move(token));
+            break;
+        }
+        if (token.type == TokenType::LEFT_BRACE || token.type == TokenType::LEFT_BRACKET) {
+            if (maxDepth_ != 0 && ++depth > maxDepth_) {
+                throw std::runtime_error("Maximum nesting depth of " + std::to_string(maxDepth_) +
+                                       " exceeded at line " + std::to_string(token.line) +
+                                       ", column " + std::to_string(token.column));
+            }
+        } else if ((token.type == TokenType::RIGHT_BRACE || token.type == TokenType::RIGHT_BRACKET) && depth > 0) {
+            depth--;
         }
-        tokens.push_back(token);
+        if (collectStats) {
+            stats->tokens[static_cast<size_t>(token.type)]++;
+        }
+        tokens.push_back(std::move(token));
     }
     
-    tokens.push_back(Token(TokenType::END_OF_FILE, "", line_, column_));
+    if (collectStats) {
+        stats->tokens[static_cast<size_t>(TokenType::END_OF_FILE)]++;
+        if (!stream_) {
+            stats->bytesLexed += input_.length();
+        }
+    }
     return tokens;
 }
 
+Token JsonLexer::scanToken() {
+    skipWhitespace();
+    if (isAtEnd()) {
+        return Token(TokenType::END_OF_FILE, "", line_, column_);
+    }
+    
+    Token token = nextToken();
+    if (token.type == TokenType::INVALID) {
+        throw std::runtime_error("Invalid token at line " + std::to_string(line_) + 
+                               ", column " + std::to_string(column_));
+    }
+    return token;
+}
+
 void JsonLexer::skipWhitespace() {
     while (!isAtEnd()) {
         char c = peek();
@@ -73,7 +156,7 @@ Token JsonLexer::parseString() {
     advance(); // Skip opening quote
     
     while (!isAtEnd() && peek() != '"') {
-        if (peek() == '\') {
+        if (peek() == '\\') {
             advance();
             if (isAtEnd()) {
                 throw std::runtime_error("Unterminated string");
@@ -81,7 +164,7 @@ Token JsonLexer::parseString() {
             char escaped = advance();
             switch (escaped) {
                 case '"': value += '"'; break;
-                case '\': value += '\'; break;
+                case '\\': value += '\\'; break;
                 case '/': value += '/'; break;
                 case 'b': value += '\b'; break;
                 case 'f': value += '\f'; break;
@@ -139,7 +222,7 @@ Token JsonLexer::parseKeyword() {
     return Token(TokenType::INVALID, value, tokenLine, tokenColumn);
 }
 
-char JsonLexer::peek() const {
+char JsonLexer::peek() {
     if (isAtEnd()) return '\0';
     return input_[current_];
 }
@@ -149,8 +232,29 @@ char JsonLexer::advance() {
     return input_[current_++];
 }
 
-bool JsonLexer::isAtEnd() const {
-    return current_ >= input_.length();
+bool JsonLexer::isAtEnd() {
+    return current_ >= input_.length() && !refill();
+}
+
+// Drops the consumed part of the buffer and reads the next chunk of a
+// streamed input. Tokens copy their text, so nothing points into the buffer.
+bool JsonLexer::refill() {
+    if (!stream_ || !*stream_) {
+        return false;
+    }
+    
+    input_.erase(0, current_);
+    current_ = 0;
+    size_t kept = input_.size();
+    input_.resize(kept + kStreamChunkSize);
+    stream_->read(&input_[kept], static_cast<std::streamsize>(kStreamChunkSize));
+    size_t count = static_cast<size_t>(stream_->gcount());
+    input_.resize(kept + count);
+    
+    if (count > 0 && JSON_STATS_ACTIVE()) {
+        Stats::current().bytesLexed += count;
+    }
+    return count > 0;
 }
 
 } // namespace json
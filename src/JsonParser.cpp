@@ -1,23 +1,67 @@
 #include "JsonParser.h"
+#include "JsonStats.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
 
 namespace json {
 
-JsonParser::JsonParser(const std::string& input) : current_(0) {
-    JsonLexer lexer(input);
+namespace {
+
+// Rough per-node costs used for the peak document memory estimate.
+const size_t kSmallStringCapacity = std::string().capacity();
+constexpr size_t kMapNodeOverhead = 4 * sizeof(void*);
+
+size_t heapStringBytes(const std::string& str) {
+    return str.capacity() > kSmallStringCapacity ? str.capacity() + 1 : 0;
+}
+
+// Rounds to nearest like JSON_STATIC. Values in the subnormal range, or that
+// underflow to zero, are kept (std::stod would throw); only overflow fails.
+double toNumber(const Token& token) {
+    errno = 0;
+    double value = std::strtod(token.value.c_str(), nullptr);
+    if (errno == ERANGE && std::isinf(value)) {
+        throw std::runtime_error("Number out of range at line " + std::to_string(token.line) +
+                                 ", column " + std::to_string(token.column));
+    }
+    return value;
+}
+
+} // namespace
+
+JsonParser::JsonParser(const std::string& input, const ParseOptions& options)
+    : current_(0), options_(options), collectStats_(false) {
+    JsonLexer lexer(input, options.maxDepth);
     tokens_ = lexer.tokenize();
 }
 
+JsonParser::JsonParser(std::istream& input, const ParseOptions& options)
+    : lexer_(std::make_unique<JsonLexer>(input, options.maxDepth)),
+      current_(0), options_(options), collectStats_(JSON_STATS_ACTIVE()) {}
+
+JsonParser::~JsonParser() = default;
+
 JsonValue JsonParser::parse() {
-    if (tokens_.empty()) {
+    if (tokens_.empty() && !lexer_) {
         throw std::runtime_error("No tokens to parse");
     }
-    return parseValue();
+    
+    collectStats_ = JSON_STATS_ACTIVE();
+    StatsTimer timer(&ParseStats::parseTime, collectStats_, &ParseStats::lexTime);
+    if (collectStats_) {
+        Stats::current().documentBytes = 0;
+    }
+    JsonValue value = parseValue();
+    expectEndOfInput();
+    return value;
 }
 
-JsonValue JsonParser::parseFile(const std::string& filename) {
+JsonValue JsonParser::parseFile(const std::string& filename, const ParseOptions& options) {
     std::ifstream file(filename);
     if (!file.is_open()) {
         throw std::runtime_error("Could not open file: " + filename);
@@ -26,91 +70,207 @@ JsonValue JsonParser::parseFile(const std::string& filename) {
     std::stringstream buffer;
     buffer << file.rdbuf();
     
-    JsonParser parser(buffer.str());
+    JsonParser parser(buffer.str(), options);
     return parser.parse();
 }
 
-JsonValue JsonParser::parseValue() {
-    const Token& token = peek();
-    
-    switch (token.type) {
-        case TokenType::LEFT_BRACE:
-            return parseObject();
-        case TokenType::LEFT_BRACKET:
-            return parseArray();
-        case TokenType::STRING:
-            advance();
-            return JsonValue(token.value);
-        case TokenType::NUMBER:
-            advance();
-            return JsonValue(std::stod(token.value));
-        case TokenType::TRUE:
-            advance();
-            return JsonValue(true);
-        case TokenType::FALSE:
-            advance();
-            return JsonValue(false);
-        case TokenType::NULL_TOKEN:
-            advance();
-            return JsonValue::makeNull();
-        default:
-            throw std::runtime_error("Unexpected token at line " + 
-                                   std::to_string(token.line) + 
-                                   ", column " + std::to_string(token.column));
-    }
-}
-
-JsonValue JsonParser::parseObject() {
-    expect(TokenType::LEFT_BRACE, "Expected '{'");
-    
-    JsonValue obj = JsonValue::makeObject();
-    
-    if (check(TokenType::RIGHT_BRACE)) {
-        advance();
-        return obj;
-    }
+// Parses one complete value starting at the current token. Nesting is tracked
+// on an explicit heap-allocated stack instead of the call stack, so deeply
+// nested input cannot overflow it.
+JsonValue JsonParser::parseValue(size_t outerDepth) {
+    std::vector<Frame> stack;
     
     while (true) {
-        expect(TokenType::STRING, "Expected string key");
-        std::string key = tokens_[current_ - 1].value;
-        
-        expect(TokenType::COLON, "Expected ':' after key");
+        JsonValue value;
+        const Token& token = peek();
         
-        JsonValue value = parseValue();
-        obj[key] = value;
+        switch (token.type) {
+            case TokenType::LEFT_BRACE:
+                advance();
+                enterContainer(outerDepth + stack.size() + 1, token);
+                if (match(TokenType::RIGHT_BRACE)) {
+                    value = recordValue(JsonValue::makeObject());
+                    break;
+                }
+                stack.push_back(Frame{recordValue(JsonValue::makeObject()), ""});
+                readKey(stack.back());
+                continue;
+            case TokenType::LEFT_BRACKET:
+                advance();
+                enterContainer(outerDepth + stack.size() + 1, token);
+                if (match(TokenType::RIGHT_BRACKET)) {
+                    value = recordValue(JsonValue::makeArray());
+                    break;
+                }
+                stack.push_back(Frame{recordValue(JsonValue::makeArray()), ""});
+                continue;
+            case TokenType::STRING:
+                advance();
+                value = recordValue(JsonValue(token.value));
+                break;
+            case TokenType::NUMBER:
+                advance();
+                value = recordValue(JsonValue(toNumber(token)));
+                break;
+            case TokenType::TRUE:
+                advance();
+                value = recordValue(JsonValue(true));
+                break;
+            case TokenType::FALSE:
+                advance();
+                value = recordValue(JsonValue(false));
+                break;
+            case TokenType::NULL_TOKEN:
+                advance();
+                value = recordValue(JsonValue::makeNull());
+                break;
+            default:
+                throw std::runtime_error("Unexpected token at line " + 
+                                       std::to_string(token.line) + 
+                                       ", column " + std::to_string(token.column));
+        }
         
-        if (!match(TokenType::COMMA)) {
-            break;
+        // Attach the finished value to its parent, closing every container
+        // that it completes along the way.
+        while (true) {
+            if (stack.empty()) {
+                return value;
+            }
+            
+            Frame& top = stack.back();
+            if (top.container.isArray()) {
+                appendElement(top.container, std::move(value));
+                if (match(TokenType::COMMA)) {
+                    break;
+                }
+                expect(TokenType::RIGHT_BRACKET, "Expected ']'");
+            } else {
+                top.container.set(top.key, std::move(value));
+                if (collectStats_) {
+                    recordMember(top.container, top.key);
+                }
+                if (match(TokenType::COMMA)) {
+                    readKey(top);
+                    break;
+                }
+                expect(TokenType::RIGHT_BRACE, "Expected '}'");
+            }
+            
+            value = std::move(top.container);
+            stack.pop_back();
         }
     }
-    
-    expect(TokenType::RIGHT_BRACE, "Expected '}'");
-    return obj;
 }
 
-JsonValue JsonParser::parseArray() {
-    expect(TokenType::LEFT_BRACKET, "Expected '['");
-    
-    JsonValue arr = JsonValue::makeArray();
-    
-    if (check(TokenType::RIGHT_BRACKET)) {
+// Consumes one complete value without building it. Only bracket balance is
+// checked; the lexer still rejects malformed tokens.
+void JsonParser::skipValue(size_t outerDepth) {
+    size_t depth = 0;
+    do {
+        const Token& token = peek();
+        switch (token.type) {
+            case TokenType::LEFT_BRACE:
+            case TokenType::LEFT_BRACKET:
+                enterContainer(outerDepth + ++depth, token);
+                break;
+            case TokenType::RIGHT_BRACE:
+            case TokenType::RIGHT_BRACKET:
+            case TokenType::END_OF_FILE:
+                if (depth == 0 || token.type == TokenType::END_OF_FILE) {
+                    throw std::runtime_error("Unexpected token at line " + 
+                                           std::to_string(token.line) + 
+                                           ", column " + std::to_string(token.column));
+                }
+                depth--;
+                break;
+            default:
+                break;
+        }
         advance();
-        return arr;
+        discardConsumedTokens();
+    } while (depth > 0);
+}
+
+// Forgets tokens that have been consumed so a streaming parser only holds
+// the tokens of the value it is working on.
+void JsonParser::discardConsumedTokens() {
+    if (lexer_ && current_ > 0) {
+        tokens_.erase(tokens_.begin(), tokens_.begin() + static_cast<std::ptrdiff_t>(current_));
+        current_ = 0;
+    }
+}
+
+void JsonParser::readKey(Frame& frame) {
+    expect(TokenType::STRING, "Expected string key");
+    frame.key = tokens_[current_ - 1].value;
+    expect(TokenType::COLON, "Expected ':' after key");
+}
+
+void JsonParser::appendElement(JsonValue& array, JsonValue&& element) {
+    if (!collectStats_) {
+        array.push_back(std::move(element));
+        return;
     }
     
-    while (true) {
-        arr.push_back(parseValue());
-        
-        if (!match(TokenType::COMMA)) {
-            break;
-        }
+    // The first element also allocates the array's shared payload.
+    bool first = array.size() == 0;
+    size_t capacityBefore = array.getArray().capacity();
+    array.push_back(std::move(element));
+    ParseStats& stats = Stats::current();
+    if (first) {
+        stats.allocations++;
+    }
+    if (array.getArray().capacity() != capacityBefore) {
+        stats.allocations++;
+    }
+}
+
+JsonValue JsonParser::recordValue(JsonValue value) {
+    if (!collectStats_) {
+        return value;
     }
     
-    expect(TokenType::RIGHT_BRACKET, "Expected ']'");
-    return arr;
+    ParseStats& stats = Stats::current();
+    stats.values[static_cast<size_t>(value.getType())]++;
+    stats.documentBytes += sizeof(JsonValue);
+    if (value.isString()) {
+        size_t heapBytes = heapStringBytes(value.asString());
+        if (heapBytes > 0) {
+            stats.allocations++;
+            stats.documentBytes += heapBytes;
+        }
+    }
+    stats.peakDocumentBytes = std::max(stats.peakDocumentBytes, stats.documentBytes);
+    return value;
+}
+
+void JsonParser::recordMember(const JsonValue& object, const std::string& key) {
+    ParseStats& stats = Stats::current();
+    size_t heapBytes = heapStringBytes(key);
+    stats.allocations += heapBytes > 0 ? 2 : 1;
+    if (object.size() == 1) {
+        stats.allocations++;  // the object's shared payload, made by its first member
+    }
+    stats.documentBytes += kMapNodeOverhead + heapBytes;
+    stats.peakDocumentBytes = std::max(stats.peakDocumentBytes, stats.documentBytes);
+}
+
+void JsonParser::enterContainer(size_t depth, const Token& token) {
+    if (options_.maxDepth != 0 && depth > options_.maxDepth) {
+        throw std::runtime_error("Maximum nesting depth of " + std::to_string(options_.maxDepth) +
+                               " exceeded at line " + std::to_string(token.line) +
+                               ", column " + std::to_string(token.column));
+    }
+    if (collectStats_) {
+        ParseStats& stats = Stats::current();
+        stats.maxDepth = std::max(stats.maxDepth, depth);
+    }
 }
 
-const Token& JsonParser::peek() const {
+const Token& JsonParser::peek() {
+    if (lexer_ && current_ >= tokens_.size()) {
+        tokens_.push_back(lexer_->next());
+    }
     return tokens_[current_];
 }
 
@@ -119,8 +279,7 @@ const Token& JsonParser::advance() {
     return tokens_[current_ - 1];
 }
 
-bool JsonParser::check(TokenType type) const {
-    if (current_ >= tokens_.size()) return false;
+bool JsonParser::check(TokenType type) {
     return peek().type == type;
 }
 
@@ -139,8 +298,18 @@ void JsonParser::expect(TokenType type, const std::string& message) {
     advance();
 }
 
-bool JsonParser::isAtEnd() const {
-    return current_ >= tokens_.size() || peek().type == TokenType::END_OF_FILE;
+// Only whitespace may follow the top-level value.
+void JsonParser::expectEndOfInput() {
+    if (!isAtEnd()) {
+        const Token& token = peek();
+        throw std::runtime_error("Unexpected data after JSON value at line " +
+                                 std::to_string(token.line) +
+                                 ", column " + std::to_string(token.column));
+    }
+}
+
+bool JsonParser::isAtEnd() {
+    return peek().type == TokenType::END_OF_FILE;
 }
 
 } // namespace json
@@ -0,0 +1,338 @@
+#include "JsonPatch.h"
+#include "JsonPointer.h"
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace json {
+
+namespace {
+
+using Path = std::vector<std::string>;
+
+// Parses an array index token of `path`. Leading zeros are rejected as
+// RFC 6901 requires.
+size_t parseIndex(const std::string& token, size_t limit, const Path& path) {
+    bool valid = !token.empty() && (token == "0" || token[0] != '0');
+    size_t index = 0;
+    for (char c : token) {
+        if (c < '0' || c > '9' || index > limit) {
+            valid = false;
+            break;
+        }
+        index = index * 10 + static_cast<size_t>(c - '0');
+    }
+    if (!valid || index >= limit) {
+        throw std::runtime_error("Invalid array index in path: " + joinPointer(path));
+    }
+    return index;
+}
+
+bool isProperPrefix(const Path& prefix, const Path& path) {
+    if (prefix.size() >= path.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < prefix.size(); ++i) {
+        if (prefix[i] != path[i]) return false;
+    }
+    return true;
+}
+
+const JsonValue& requireMember(const JsonValue& op, const std::string& key) {
+    const JsonValue* member = op.find(key);
+    if (!member) {
+        throw std::runtime_error("Patch operation is missing '" + key + "'");
+    }
+    return *member;
+}
+
+Path requirePath(const JsonValue& op, const std::string& key) {
+    const JsonValue& member = requireMember(op, key);
+    if (!member.isString()) {
+        throw std::runtime_error("Patch operation '" + key + "' must be a string");
+    }
+    return splitPointer(member.asString());
+}
+
+// Mutates a document through a small set of primitives and records how to
+// undo each one. Undo entries hold the values they displaced (moved, not
+// copied) plus the path to re-resolve, since array edits may relocate nodes.
+class Transaction {
+public:
+    explicit Transaction(JsonValue& root) : root_(root) {}
+
+    JsonValue& get(const Path& path) {
+        return resolve(path, path.size());
+    }
+
+    // Read-only lookup. Unlike get() it never clones a payload the document
+    // shares with a copy, so `test` and the source of `copy` cost nothing.
+    const JsonValue& lookup(const Path& path) const {
+        const JsonValue* current = &root_;
+        for (const std::string& token : path) {
+            if (current->isObject()) {
+                current = current->find(token);
+            } else if (current->isArray()) {
+                current = &current->getArray()[parseIndex(token, current->size(), path)];
+            } else {
+                current = nullptr;
+            }
+            if (!current) {
+                throw std::runtime_error("Path not found: " + joinPointer(path));
+            }
+        }
+        return *current;
+    }
+
+    // Adds or overwrites the value at `path` ("-" appends to an array).
+    // `value` is only moved from once the path has been validated.
+    void add(Path path, JsonValue&& value) {
+        if (path.empty()) {
+            log_.push_back(Undo{UndoKind::Restore, std::move(path), std::move(root_), false});
+            root_ = std::move(value);
+            return;
+        }
+
+        JsonValue& parent = resolve(path, path.size() - 1);
+        if (parent.isObject()) {
+            JsonValue* existing = detail::JsonValueAccess::find(parent, path.back());
+            if (existing) {
+                log_.push_back(Undo{UndoKind::Restore, std::move(path), std::move(*existing), false});
+                *existing = std::move(value);
+            } else {
+                parent.set(path.back(), std::move(value));
+                log_.push_back(Undo{UndoKind::Remove, std::move(path), JsonValue(), false});
+            }
+        } else if (parent.isArray()) {
+            size_t index = path.back() == "-" ? parent.size() : parseIndex(path.back(), parent.size() + 1, path);
+            parent.insert(index, std::move(value));
+            path.back() = std::to_string(index);
+            log_.push_back(Undo{UndoKind::Remove, std::move(path), JsonValue(), false});
+        } else {
+            throw std::runtime_error("Parent is not a container: " + joinPointer(path));
+        }
+    }
+
+    // Takes the value at `path` out of the document. Undo reinserts whatever
+    // the next undone entry displaces, which is how a move is reverted
+    // without copying the moved value.
+    JsonValue detach(Path path) {
+        if (path.empty()) {
+            throw std::runtime_error("Cannot remove the document root");
+        }
+
+        JsonValue& parent = resolve(path, path.size() - 1);
+        JsonValue removed;
+        if (parent.isObject()) {
+            if (!parent.hasKey(path.back())) {
+                throw std::runtime_error("Path not found: " + joinPointer(path));
+            }
+            removed = parent.erase(path.back());
+        } else if (parent.isArray()) {
+            size_t index = parseIndex(path.back(), parent.size(), path);
+            removed = parent.erase(index);
+            path.back() = std::to_string(index);
+        } else {
+            throw std::runtime_error("Path not found: " + joinPointer(path));
+        }
+        log_.push_back(Undo{UndoKind::Insert, std::move(path), JsonValue(), true});
+        return removed;
+    }
+
+    void remove(Path path) {
+        JsonValue removed = detach(std::move(path));
+        log_.back().value = std::move(removed);
+        log_.back().useDisplaced = false;
+    }
+
+    void move(Path from, Path path) {
+        JsonValue value = detach(std::move(from));
+        try {
+            add(std::move(path), std::move(value));
+        } catch (...) {
+            log_.back().value = std::move(value);
+            log_.back().useDisplaced = false;
+            throw;
+        }
+    }
+
+    void replace(Path path, JsonValue&& value) {
+        JsonValue& target = get(path);
+        JsonValue previous = std::move(target);
+        target = std::move(value);
+        log_.push_back(Undo{UndoKind::Restore, std::move(path), std::move(previous), false});
+    }
+
+    void rollback() {
+        JsonValue displaced;
+        for (auto it = log_.rbegin(); it != log_.rend(); ++it) {
+            Undo& undo = *it;
+            switch (undo.kind) {
+                case UndoKind::Restore: {
+                    JsonValue& target = get(undo.path);
+                    displaced = std::move(target);
+                    target = std::move(undo.value);
+                    break;
+                }
+                case UndoKind::Remove: {
+                    JsonValue& parent = resolve(undo.path, undo.path.size() - 1);
+                    displaced = parent.isObject() ? parent.erase(undo.path.back())
+                                                  : parent.erase(std::stoul(undo.path.back()));
+                    break;
+                }
+                case UndoKind::Insert: {
+                    JsonValue& parent = resolve(undo.path, undo.path.size() - 1);
+                    JsonValue value = undo.useDisplaced ? std::move(displaced) : std::move(undo.value);
+                    if (parent.isObject()) {
+                        parent.set(undo.path.back(), std::move(value));
+                    } else {
+                        parent.insert(std::stoul(undo.path.back()), std::move(value));
+                    }
+                    break;
+                }
+            }
+        }
+        log_.clear();
+    }
+
+private:
+    enum class UndoKind { Restore, Remove, Insert };
+
+    struct Undo {
+        UndoKind kind;
+        Path path;
+        JsonValue value;
+        bool useDisplaced;
+    };
+
+    JsonValue& resolve(const Path& path, size_t count) {
+        JsonValue* current = &root_;
+        for (size_t i = 0; i < count; ++i) {
+            const std::string& token = path[i];
+            if (current->isObject()) {
+                current = detail::JsonValueAccess::find(*current, token);
+            } else if (current->isArray()) {
+                current = &detail::JsonValueAccess::at(*current, parseIndex(token, current->size(), path));
+            } else {
+                current = nullptr;
+            }
+            if (!current) {
+                throw std::runtime_error("Path not found: " + joinPointer(path));
+            }
+        }
+        return *current;
+    }
+
+    JsonValue& root_;
+    std::vector<Undo> log_;
+};
+
+void applyOperation(Transaction& tx, const JsonValue& op) {
+    if (!op.isObject()) {
+        throw std::runtime_error("Patch operation must be an object");
+    }
+    const JsonValue& name = requireMember(op, "op");
+    if (!name.isString()) {
+        throw std::runtime_error("Patch operation 'op' must be a string");
+    }
+    const std::string& kind = name.asString();
+    Path path = requirePath(op, "path");
+
+    if (kind == "add") {
+        tx.add(std::move(path), JsonValue(requireMember(op, "value")));
+    } else if (kind == "remove") {
+        tx.remove(std::move(path));
+    } else if (kind == "replace") {
+        tx.replace(std::move(path), JsonValue(requireMember(op, "value")));
+    } else if (kind == "move") {
+        Path from = requirePath(op, "from");
+        if (from == path) {
+            tx.lookup(from);
+            return;
+        }
+        if (isProperPrefix(from, path)) {
+            throw std::runtime_error("Cannot move a value into one of its children: " + joinPointer(path));
+        }
+        tx.move(std::move(from), std::move(path));
+    } else if (kind == "copy") {
+        Path from = requirePath(op, "from");
+        JsonValue value = tx.lookup(from);
+        tx.add(std::move(path), std::move(value));
+    } else if (kind == "test") {
+        if (tx.lookup(path) != requireMember(op, "value")) {
+            throw std::runtime_error("Test failed at path: " + joinPointer(path));
+        }
+    } else {
+        throw std::runtime_error("Unknown patch operation: " + kind);
+    }
+}
+
+void applyMergeMembers(Transaction& tx, const JsonValue& patch) {
+    // Nested patch objects are handled with an explicit worklist.
+    std::vector<std::pair<Path, const JsonValue*>> pending;
+    pending.emplace_back(Path(), &patch);
+
+    while (!pending.empty()) {
+        Path path = std::move(pending.back().first);
+        const JsonValue& current = *pending.back().second;
+        pending.pop_back();
+
+        if (!current.isObject()) {
+            tx.replace(std::move(path), JsonValue(current));
+            continue;
+        }
+        if (!tx.lookup(path).isObject()) {
+            tx.replace(path, JsonValue::makeObject());
+        }
+
+        for (const auto& member : current.getObject()) {
+            Path child = path;
+            child.push_back(member.first);
+            bool exists = tx.lookup(path).hasKey(member.first);
+
+            if (member.second.isNull()) {
+                if (exists) {
+                    tx.remove(std::move(child));
+                }
+            } else if (member.second.isObject()) {
+                if (!exists) {
+                    tx.add(child, JsonValue::makeObject());
+                }
+                pending.emplace_back(std::move(child), &member.second);
+            } else {
+                tx.add(std::move(child), JsonValue(member.second));
+            }
+        }
+    }
+}
+
+} // namespace
+
+void JsonPatch::apply(JsonValue& document, const JsonValue& patch) {
+    if (!patch.isArray()) {
+        throw std::runtime_error("JSON Patch must be an array of operations");
+    }
+
+    Transaction tx(document);
+    try {
+        for (const auto& op : patch.getArray()) {
+            applyOperation(tx, op);
+        }
+    } catch (...) {
+        tx.rollback();
+        throw;
+    }
+}
+
+void JsonPatch::applyMerge(JsonValue& document, const JsonValue& patch) {
+    Transaction tx(document);
+    try {
+        applyMergeMembers(tx, patch);
+    } catch (...) {
+        tx.rollback();
+        throw;
+    }
+}
+
+} // namespace json
@@ -0,0 +1,74 @@
+#include "JsonPath.h"
+
+namespace json {
+
+std::vector<std::string> splitPath(const std::string& path) {
+    std::vector<std::string> segments;
+    std::string current;
+
+    for (size_t i = 0; i < path.size(); ++i) {
+        char c = path[i];
+        if (c == '.') {
+            if (!current.empty()) {
+                segments.push_back(current);
+                current.clear();
+            }
+        } else if (c == '[') {
+            if (!current.empty()) {
+                segments.push_back(current);
+                current.clear();
+            }
+            size_t close = path.find(']', i);
+            if (close == std::string::npos) {
+                // Unterminated index: keep the rest as a plain key.
+                current = path.substr(i);
+                break;
+            }
+            segments.push_back(path.substr(i, close - i + 1));
+            i = close;
+        } else {
+            current += c;
+        }
+    }
+    if (!current.empty()) {
+        segments.push_back(current);
+    }
+    return segments;
+}
+
+std::optional<const JsonValue*> queryPath(const JsonValue& root, const std::string& path) {
+    const JsonValue* current = &root;
+
+    for (const auto& segment : splitPath(path)) {
+        if (segment.size() > 2 && segment.front() == '[' && segment.back() == ']') {
+            if (!current->isArray()) {
+                return std::nullopt;
+            }
+            size_t index = 0;
+            for (size_t i = 1; i + 1 < segment.size(); ++i) {
+                char c = segment[i];
+                if (c < '0' || c > '9' || index > current->size()) {
+                    return std::nullopt;
+                }
+                index = index * 10 + static_cast<size_t>(c - '0');
+            }
+            if (index >= current->size()) {
+                return std::nullopt;
+            }
+            current = &current->getArray()[index];
+        } else {
+            if (!current->isObject()) {
+                return std::nullopt;
+            }
+            const auto& members = current->getObject();
+            auto member = members.find(segment);
+            if (member == members.end()) {
+                return std::nullopt;
+            }
+            current = &member->second;
+        }
+    }
+    return current;
+}
+
+} // namespace json
@@ -0,0 +1,660 @@
+#include "JsonPattern.h"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace json {
+
+namespace {
+
+constexpr char32_t kMaxCodePoint = 0x10FFFF;
+constexpr char32_t kReplacement = 0xFFFD;
+constexpr size_t kUnbounded = static_cast<size_t>(-1);
+
+// Limits that keep a hostile schema from exhausting the stack or memory.
+constexpr size_t kMaxGroupDepth = 256;
+constexpr size_t kMaxRepeat = 1000;
+constexpr size_t kMaxProgram = 100000;
+
+enum class Assertion : uint32_t { Begin, End, WordBoundary, NotWordBoundary };
+
+using Ranges = std::vector<std::pair<char32_t, char32_t>>;
+
+// Decodes the code point at text[i] and advances i past it. Malformed
+// sequences decode to U+FFFD one byte at a time.
+char32_t decodeUtf8(const std::string& text, size_t& i) {
+    auto byte = [&](size_t k) { return static_cast<unsigned char>(text[k]); };
+    unsigned char lead = byte(i);
+    if (lead < 0x80) {
+        i++;
+        return lead;
+    }
+    size_t length = (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+    if (length == 0 || i + length > text.size()) {
+        i++;
+        return kReplacement;
+    }
+    char32_t cp = static_cast<char32_t>(lead & (0xFF >> (length + 1)));
+    for (size_t k = 1; k < length; ++k) {
+        if ((byte(i + k) & 0xC0) != 0x80) {
+            i++;
+            return kReplacement;
+        }
+        cp = (cp << 6) | (byte(i + k) & 0x3F);
+    }
+    static const char32_t kMinimum[] = {0, 0, 0x80, 0x800, 0x10000};
+    if (cp < kMinimum[length] || cp > kMaxCodePoint || (cp >= 0xD800 && cp <= 0xDFFF)) {
+        i++;
+        return kReplacement;
+    }
+    i += length;
+    return cp;
+}
+
+std::vector<char32_t> decodeAll(const std::string& text) {
+    std::vector<char32_t> codePoints;
+    codePoints.reserve(text.size());
+    for (size_t i = 0; i < text.size();) {
+        codePoints.push_back(decodeUtf8(text, i));
+    }
+    return codePoints;
+}
+
+bool isLineTerminator(char32_t c) {
+    return c == '\n' || c == '\r' || c == 0x2028 || c == 0x2029;
+}
+
+bool isWordChar(char32_t c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+// Sorts and merges overlapping ranges, optionally complementing the set.
+Ranges normalize(Ranges ranges, bool negate) {
+    std::sort(ranges.begin(), ranges.end());
+    Ranges merged;
+    for (const auto& range : ranges) {
+        if (!merged.empty() && range.first <= merged.back().second + 1) {
+            merged.back().second = std::max(merged.back().second, range.second);
+        } else {
+            merged.push_back(range);
+        }
+    }
+    if (!negate) {
+        return merged;
+    }
+    Ranges complement;
+    char32_t next = 0;
+    for (const auto& range : merged) {
+        if (range.first > next) complement.emplace_back(next, range.first - 1);
+        next = range.second + 1;
+    }
+    if (next <= kMaxCodePoint) complement.emplace_back(next, kMaxCodePoint);
+    return complement;
+}
+
+// The ranges of \d, \w and \s (and, negated, \D, \W and \S).
+Ranges classEscape(char32_t letter) {
+    Ranges ranges;
+    switch (letter) {
+        case 'd': case 'D':
+            ranges = {{'0', '9'}};
+            break;
+        case 'w': case 'W':
+            ranges = {{'0', '9'}, {'A', 'Z'}, {'_', '_'}, {'a', 'z'}};
+            break;
+        default:
+            ranges = {{'\t', '\r'}, {' ', ' '}, {0xA0, 0xA0}, {0x1680, 0x1680}, {0x2000, 0x200A},
+                      {0x2028, 0x2029}, {0x202F, 0x202F}, {0x205F, 0x205F}, {0x3000, 0x3000}, {0xFEFF, 0xFEFF}};
+            break;
+    }
+    return normalize(std::move(ranges), letter == 'D' || letter == 'W' || letter == 'S');
+}
+
+bool isClassEscape(char32_t c) {
+    return c == 'd' || c == 'D' || c == 'w' || c == 'W' || c == 's' || c == 'S';
+}
+
+} // namespace
+
+struct PatternProgram {
+    enum class Op : uint8_t { Char, Any, Class, Split, Jump, Assert, Match };
+
+    struct Instruction {
+        Op op;
+        uint32_t x;  // code point, class, assertion, or first target
+        uint32_t y;  // second target of a Split
+    };
+
+    std::vector<Instruction> code;
+    std::vector<Ranges> classes;
+
+    bool inClass(uint32_t index, char32_t c) const {
+        const Ranges& ranges = classes[index];
+        auto it = std::upper_bound(ranges.begin(), ranges.end(), std::make_pair(c, static_cast<char32_t>(kMaxCodePoint + 1)));
+        return it != ranges.begin() && c <= std::prev(it)->second;
+    }
+};
+
+namespace {
+
+using Op = PatternProgram::Op;
+
+// Syntax tree built by the parser. Nodes live in one vector and refer to
+// their children by index.
+struct Node {
+    enum class Kind { Char, Any, Class, Sequence, Alternation, Repeat, Assert };
+
+    Kind kind;
+    uint32_t value = 0;  // code point, class index or assertion
+    size_t min = 0;
+    size_t max = 0;
+    std::vector<size_t> children;
+};
+
+class PatternCompiler {
+public:
+    PatternCompiler(const std::string& source, PatternProgram& program)
+        : pattern_(decodeAll(source)), program_(program) {}
+
+    void compile() {
+        size_t root = parseDisjunction(0);
+        if (pos_ < pattern_.size()) {
+            fail("unmatched ')'");
+        }
+        generate(root);
+        emit(Op::Match);
+    }
+
+private:
+    [[noreturn]] void fail(const std::string& message) const {
+        throw std::runtime_error(message + " at offset " + std::to_string(pos_));
+    }
+
+    bool atEnd() const { return pos_ >= pattern_.size(); }
+    char32_t peek(size_t ahead = 0) const { return pos_ + ahead < pattern_.size() ? pattern_[pos_ + ahead] : 0; }
+
+    size_t addNode(Node::Kind kind, uint32_t value = 0) {
+        nodes_.push_back(Node{kind, value, 0, 0, {}});
+        return nodes_.size() - 1;
+    }
+
+    size_t addClass(Ranges ranges) {
+        program_.classes.push_back(std::move(ranges));
+        return addNode(Node::Kind::Class, static_cast<uint32_t>(program_.classes.size() - 1));
+    }
+
+    // Disjunction := Alternative ('|' Alternative)*. Only group nesting
+    // recurses, and that is bounded by kMaxGroupDepth.
+    size_t parseDisjunction(size_t depth) {
+        if (depth > kMaxGroupDepth) {
+            fail("groups nested too deeply");
+        }
+        size_t alternation = addNode(Node::Kind::Alternation);
+        while (true) {
+            size_t alternative = parseAlternative(depth);
+            nodes_[alternation].children.push_back(alternative);
+            if (atEnd() || peek() != '|') break;
+            pos_++;
+        }
+        return alternation;
+    }
+
+    size_t parseAlternative(size_t depth) {
+        size_t sequence = addNode(Node::Kind::Sequence);
+        while (!atEnd() && peek() != '|' && peek() != ')') {
+            size_t atom = parseAtom(depth);
+            if (nodes_[atom].kind != Node::Kind::Assert) {
+                atom = parseQuantifier(atom);
+            } else if (isQuantifier()) {
+                fail("nothing to repeat");
+            }
+            nodes_[sequence].children.push_back(atom);
+        }
+        return sequence;
+    }
+
+    size_t parseAtom(size_t depth) {
+        char32_t c = pattern_[pos_++];
+        switch (c) {
+            case '^': return addNode(Node::Kind::Assert, static_cast<uint32_t>(Assertion::Begin));
+            case '$': return addNode(Node::Kind::Assert, static_cast<uint32_t>(Assertion::End));
+            case '.': return addNode(Node::Kind::Any);
+            case '[': return parseClass();
+            case '\\': return parseEscape();
+            case '(': {
+                if (peek() == '?') {
+                    if (peek(1) == ':') {
+                        pos_ += 2;
+                    } else if (peek(1) == '<' && peek(2) != '=' && peek(2) != '!') {
+                        // A named group; names only matter to backreferences.
+                        while (!atEnd() && peek() != '>') pos_++;
+                        if (atEnd()) fail("unterminated group name");
+                        pos_++;
+                    } else {
+                        fail("lookaround assertions are not supported");
+                    }
+                }
+                size_t group = parseDisjunction(depth + 1);
+                if (atEnd() || peek() != ')') {
+                    fail("missing ')'");
+                }
+                pos_++;
+                return group;
+            }
+            case '*':
+            case '+':
+            case '?':
+                pos_--;
+                fail("nothing to repeat");
+            case '{':
+                pos_--;
+                if (isQuantifier()) fail("nothing to repeat");
+                pos_++;
+                return addNode(Node::Kind::Char, c);
+            default:
+                return addNode(Node::Kind::Char, c);
+        }
+    }
+
+    bool readNumber(size_t& value) {
+        if (atEnd() || peek() < '0' || peek() > '9') {
+            return false;
+        }
+        value = 0;
+        while (!atEnd() && peek() >= '0' && peek() <= '9') {
+            value = std::min<size_t>(value * 10 + (peek() - '0'), kMaxRepeat + 1);
+            pos_++;
+        }
+        return true;
+    }
+
+    // Parses {n}, {n,} or {n,m} at pos_ into `min` and `max`. Leaves pos_
+    // untouched and returns false when the brace is just a literal.
+    bool readBraces(size_t& min, size_t& max) {
+        size_t start = pos_;
+        pos_++;
+        if (readNumber(min)) {
+            max = min;
+            if (peek() == ',') {
+                pos_++;
+                max = kUnbounded;
+                readNumber(max);
+            }
+            if (peek() == '}') {
+                pos_++;
+                return true;
+            }
+        }
+        pos_ = start;
+        return false;
+    }
+
+    bool isQuantifier() {
+        if (atEnd()) return false;
+        if (peek() == '*' || peek() == '+' || peek() == '?') return true;
+        size_t min = 0;
+        size_t max = 0;
+        size_t start = pos_;
+        bool braces = peek() == '{' && readBraces(min, max);
+        pos_ = start;
+        return braces;
+    }
+
+    size_t parseQuantifier(size_t atom) {
+        if (atEnd()) return atom;
+        size_t min = 0;
+        size_t max = 0;
+        switch (peek()) {
+            case '*': min = 0; max = kUnbounded; pos_++; break;
+            case '+': min = 1; max = kUnbounded; pos_++; break;
+            case '?': min = 0; max = 1; pos_++; break;
+            case '{':
+                if (!readBraces(min, max)) return atom;
+                break;
+            default:
+                return atom;
+        }
+        if (min > max) {
+            fail("numbers out of order in {} quantifier");
+        }
+        if (min > kMaxRepeat || (max != kUnbounded && max > kMaxRepeat)) {
+            fail("repetition count above " + std::to_string(kMaxRepeat));
+        }
+        if (peek() == '?') {
+            pos_++;  // lazy and greedy quantifiers accept the same strings
+        }
+        if (isQuantifier()) {
+            fail("nothing to repeat");
+        }
+        size_t repeat = addNode(Node::Kind::Repeat);
+        nodes_[repeat].min = min;
+        nodes_[repeat].max = max;
+        nodes_[repeat].children.push_back(atom);
+        return repeat;
+    }
+
+    // Reads \t, \n, \xHH, \uHHHH and the other escapes that stand for a
+    // single character; `c` is the letter after the backslash. Escapes this
+    // subset cannot honour, such as backreferences, are rejected.
+    char32_t characterEscape(char32_t c, bool inClass) {
+        auto hex = [&](size_t digits, char32_t& value) {
+            value = 0;
+            for (size_t k = 0; k < digits; ++k) {
+                char32_t h = peek(k);
+                int digit = h >= '0' && h <= '9' ? int(h - '0')
+                          : h >= 'a' && h <= 'f' ? int(h - 'a' + 10)
+                          : h >= 'A' && h <= 'F' ? int(h - 'A' + 10) : -1;
+                if (pos_ + k >= pattern_.size() || digit < 0) return false;
+                value = value * 16 + static_cast<char32_t>(digit);
+            }
+            pos_ += digits;
+            return true;
+        };
+
+        char32_t value = 0;
+        switch (c) {
+            case 't': return '\t';
+            case 'n': return '\n';
+            case 'v': return '\v';
+            case 'f': return '\f';
+            case 'r': return '\r';
+            case 'b': return '\b';  // only reached inside a class
+            case '0':
+                if (peek() >= '0' && peek() <= '9') fail("octal escapes are not supported");
+                return 0;
+            case 'x':
+                return hex(2, value) ? value : c;
+            case 'u':
+                if (!hex(4, value)) return c;
+                // A surrogate pair spelled as two escapes is one code point.
+                if (value >= 0xD800 && value <= 0xDBFF && peek() == '\\' && peek(1) == 'u') {
+                    size_t start = pos_;
+                    pos_ += 2;
+                    char32_t low = 0;
+                    if (hex(4, low) && low >= 0xDC00 && low <= 0xDFFF) {
+                        return 0x10000 + ((value - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    pos_ = start;
+                }
+                return value;
+            case 'c':
+                if ((peek() >= 'a' && peek() <= 'z') || (peek() >= 'A' && peek() <= 'Z')) {
+                    return pattern_[pos_++] % 32;
+                }
+                fail("invalid control escape");
+            case 'k':
+            case 'p':
+            case 'P':
+                fail(std::string("\\") + static_cast<char>(c) + " escapes are not supported");
+            default:
+                if (c >= '1' && c <= '9') {
+                    if (inClass) fail("octal escapes are not supported");
+                    fail("backreferences are not supported");
+                }
+                return c;  // identity escape, e.g. \. or \/
+        }
+    }
+
+    size_t parseEscape() {
+        if (atEnd()) {
+            fail("\\ at end of pattern");
+        }
+        char32_t c = pattern_[pos_++];
+        if (isClassEscape(c)) {
+            return addClass(classEscape(c));
+        }
+        if (c == 'b' || c == 'B') {
+            Assertion kind = c == 'b' ? Assertion::WordBoundary : Assertion::NotWordBoundary;
+            return addNode(Node::Kind::Assert, static_cast<uint32_t>(kind));
+        }
+        return addNode(Node::Kind::Char, characterEscape(c, false));
+    }
+
+    // One class member: a character, or a set when `set` is filled in.
+    char32_t classAtom(Ranges& set) {
+        char32_t c = pattern_[pos_++];
+        if (c != '\\') {
+            return c;
+        }
+        if (atEnd()) {
+            fail("\\ at end of pattern");
+        }
+        c = pattern_[pos_++];
+        if (isClassEscape(c)) {
+            set = classEscape(c);
+            return 0;
+        }
+        return characterEscape(c, true);
+    }
+
+    size_t parseClass() {
+        bool negate = peek() == '^';
+        if (negate) pos_++;
+
+        Ranges ranges;
+        while (true) {
+            if (atEnd()) {
+                fail("missing ']'");
+            }
+            if (peek() == ']') {
+                pos_++;
+                break;
+            }
+            Ranges lowSet;
+            char32_t low = classAtom(lowSet);
+            if (peek() == '-' && peek(1) != ']' && pos_ + 1 < pattern_.size()) {
+                pos_++;
+                Ranges highSet;
+                char32_t high = classAtom(highSet);
+                if (lowSet.empty() && highSet.empty()) {
+                    if (low > high) fail("range out of order in character class");
+                    ranges.emplace_back(low, high);
+                    continue;
+                }
+                // A set on either side makes the '-' literal, as in [\d-z].
+                ranges.emplace_back('-', '-');
+                if (highSet.empty()) ranges.emplace_back(high, high);
+                ranges.insert(ranges.end(), highSet.begin(), highSet.end());
+            }
+            if (lowSet.empty()) ranges.emplace_back(low, low);
+            ranges.insert(ranges.end(), lowSet.begin(), lowSet.end());
+        }
+        return addClass(normalize(std::move(ranges), negate));
+    }
+
+    // -----------------------------------------------------------------------
+    // Code generation. Recursion follows the syntax tree, whose depth is
+    // bounded by the group nesting limit.
+
+    size_t emit(Op op, uint32_t x = 0, uint32_t y = 0) {
+        if (program_.code.size() >= kMaxProgram) {
+            throw std::runtime_error("pattern is too large");
+        }
+        program_.code.push_back(PatternProgram::Instruction{op, x, y});
+        return program_.code.size() - 1;
+    }
+
+    uint32_t here() const {
+        return static_cast<uint32_t>(program_.code.size());
+    }
+
+    void generate(size_t index) {
+        const Node& node = nodes_[index];
+        switch (node.kind) {
+            case Node::Kind::Char:
+                emit(Op::Char, node.value);
+                break;
+            case Node::Kind::Any:
+                emit(Op::Any);
+                break;
+            case Node::Kind::Class:
+                emit(Op::Class, node.value);
+                break;
+            case Node::Kind::Assert:
+                emit(Op::Assert, node.value);
+                break;
+            case Node::Kind::Sequence:
+                for (size_t child : node.children) generate(child);
+                break;
+            case Node::Kind::Alternation: {
+                std::vector<size_t> exits;
+                for (size_t i = 0; i + 1 < node.children.size(); ++i) {
+                    size_t split = emit(Op::Split, here() + 1);
+                    generate(node.children[i]);
+                    exits.push_back(emit(Op::Jump));
+                    program_.code[split].y = here();
+                }
+                generate(node.children.back());
+                for (size_t exit : exits) program_.code[exit].x = here();
+                break;
+            }
+            case Node::Kind::Repeat: {
+                size_t child = node.children.front();
+                for (size_t i = 0; i < node.min; ++i) generate(child);
+                if (node.max == kUnbounded) {
+                    uint32_t loop = here();
+                    size_t split = emit(Op::Split, loop + 1);
+                    generate(child);
+                    emit(Op::Jump, loop);
+                    program_.code[split].y = here();
+                } else {
+                    // Each optional copy may be skipped straight to the end.
+                    std::vector<size_t> splits;
+                    for (size_t i = node.min; i < node.max; ++i) {
+                        splits.push_back(emit(Op::Split, here() + 1));
+                        generate(child);
+                    }
+                    for (size_t split : splits) program_.code[split].y = here();
+                }
+                break;
+            }
+        }
+    }
+
+    std::vector<char32_t> pattern_;
+    size_t pos_ = 0;
+    std::vector<Node> nodes_;
+    PatternProgram& program_;
+};
+
+// The set of threads alive at one input position: a sparse set of program
+// counters, cleared in O(1).
+class ThreadList {
+public:
+    explicit ThreadList(size_t size) : sparse_(size), matched_(false) {}
+
+    bool insert(uint32_t pc) {
+        if (sparse_[pc] < dense_.size() && dense_[sparse_[pc]] == pc) {
+            return false;
+        }
+        sparse_[pc] = static_cast<uint32_t>(dense_.size());
+        dense_.push_back(pc);
+        return true;
+    }
+
+    void clear() {
+        dense_.clear();
+        matched_ = false;
+    }
+
+    const std::vector<uint32_t>& threads() const { return dense_; }
+    bool matched() const { return matched_; }
+    void setMatched() { matched_ = true; }
+
+private:
+    std::vector<uint32_t> sparse_;
+    std::vector<uint32_t> dense_;
+    bool matched_;
+};
+
+bool assertionHolds(Assertion kind, const std::vector<char32_t>& input, size_t pos) {
+    switch (kind) {
+        case Assertion::Begin:
+            return pos == 0;
+        case Assertion::End:
+            return pos == input.size();
+        default: {
+            bool before = pos > 0 && isWordChar(input[pos - 1]);
+            bool after = pos < input.size() && isWordChar(input[pos]);
+            return (before != after) == (kind == Assertion::WordBoundary);
+        }
+    }
+}
+
+// Adds the thread at `pc` and everything reachable from it without
+// consuming input. The closure is walked with an explicit stack.
+void addThread(const PatternProgram& program, ThreadList& list, uint32_t pc, const std::vector<char32_t>& input,
+               size_t pos, std::vector<uint32_t>& stack) {
+    stack.push_back(pc);
+    while (!stack.empty()) {
+        uint32_t at = stack.back();
+        stack.pop_back();
+        if (!list.insert(at)) {
+            continue;
+        }
+        const PatternProgram::Instruction& instruction = program.code[at];
+        switch (instruction.op) {
+            case Op::Jump:
+                stack.push_back(instruction.x);
+                break;
+            case Op::Split:
+                stack.push_back(instruction.y);
+                stack.push_back(instruction.x);
+                break;
+            case Op::Assert:
+                if (assertionHolds(static_cast<Assertion>(instruction.x), input, pos)) {
+                    stack.push_back(at + 1);
+                }
+                break;
+            case Op::Match:
+                list.setMatched();
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+} // namespace
+
+JsonPattern::JsonPattern(const std::string& source) : source_(source) {
+    auto program = std::make_shared<PatternProgram>();
+    PatternCompiler(source, *program).compile();
+    program_ = std::move(program);
+}
+
+bool JsonPattern::search(const std::string& text) const {
+    const PatternProgram& program = *program_;
+    std::vector<char32_t> input = decodeAll(text);
+    ThreadList current(program.code.size());
+    ThreadList next(program.code.size());
+    std::vector<uint32_t> stack;
+
+    for (size_t pos = 0;; ++pos) {
+        // A new attempt starts at every position, so the search is unanchored.
+        addThread(program, current, 0, input, pos, stack);
+        if (current.matched()) {
+            return true;
+        }
+        if (pos == input.size()) {
+            return false;
+        }
+
+        char32_t c = input[pos];
+        next.clear();
+        for (uint32_t pc : current.threads()) {
+            const PatternProgram::Instruction& instruction = program.code[pc];
+            bool advances = (instruction.op == Op::Char && instruction.x == c) ||
+                            (instruction.op == Op::Any && !isLineTerminator(c)) ||
+                            (instruction.op == Op::Class && program.inClass(instruction.x, c));
+            if (advances) {
+                addThread(program, next, pc + 1, input, pos + 1, stack);
+            }
+        }
+        std::swap(current, next);
+    }
+}
+
+} // namespace json
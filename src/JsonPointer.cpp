@@ -0,0 +1,63 @@
+#include "JsonPointer.h"
+#include <stdexcept>
+
+namespace json {
+
+std::string escapePointerToken(const std::string& token) {
+    std::string escaped;
+    escaped.reserve(token.size());
+    for (char c : token) {
+        if (c == '~') {
+            escaped += "~0";
+        } else if (c == '/') {
+            escaped += "~1";
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+std::vector<std::string> splitPointer(const std::string& pointer) {
+    std::vector<std::string> tokens;
+    if (pointer.empty()) {
+        return tokens;
+    }
+    if (pointer[0] != '/') {
+        throw std::runtime_error("JSON Pointer must start with '/': " + pointer);
+    }
+    
+    std::string current;
+    for (size_t i = 1; i < pointer.size(); ++i) {
+        char c = pointer[i];
+        if (c == '/') {
+            tokens.push_back(current);
+            current.clear();
+        } else if (c == '~') {
+            char next = i + 1 < pointer.size() ? pointer[i + 1] : '\0';
+            if (next == '0') {
+                current += '~';
+            } else if (next == '1') {
+                current += '/';
+            } else {
+                throw std::runtime_error("Invalid escape in JSON Pointer: " + pointer);
+            }
+            ++i;
+        } else {
+            current += c;
+        }
+    }
+    tokens.push_back(current);
+    return tokens;
+}
+
+std::string joinPointer(const std::vector<std::string>& tokens) {
+    std::string pointer;
+    for (const auto& token : tokens) {
+        pointer += '/';
+        pointer += escapePointerToken(token);
+    }
+    return pointer;
+}
+
+} // namespace json
@@ -1,111 +1,115 @@
 #include "JsonPrinter.h"
+#include "JsonStats.h"
 #include <sstream>
+#include <vector>
 
 namespace json {
 
 std::string JsonPrinter::print(const JsonValue& value, bool pretty, int indent) {
+    const bool collectStats = JSON_STATS_ACTIVE();
+    StatsTimer timer(&ParseStats::printTime, collectStats);
+    
     std::string output;
     printValue(value, output, pretty, indent, 0);
+    if (collectStats) {
+        Stats::current().bytesPrinted += output.size();
+    }
     return output;
 }
 
+namespace {
+
+// An array or object whose members are still being written.
+struct PrintFrame {
+    const JsonValue* container;
+    size_t index;
+    std::map<std::string, JsonValue>::const_iterator member;
+    int indent;
+};
+
+} // namespace
+
+// Walks the tree with an explicit stack so arbitrarily deep documents print
+// without recursion. Containers are opened when first reached and closed once
+// their last member has been written.
 void JsonPrinter::printValue(const JsonValue& value, std::string& output, bool pretty, int indent, int currentIndent) {
-    switch (value.getType()) {
-        case ValueType::NULL_TYPE:
-            output += "null";
-            break;
-            
-        case ValueType::BOOLEAN:
-            output += value.asBool() ? "true" : "false";
-            break;
-            
-        case ValueType::NUMBER: {
-            std::ostringstream oss;
-            oss << value.asNumber();
-            output += oss.str();
-            break;
-        }
-            
-        case ValueType::STRING:
-            output += "\"" + escapeString(value.asString()) + "\"";
-            break;
-            
-        case ValueType::ARRAY: {
-            output += "[";
-            const auto& arr = value.getArray();
-            
-            if (!arr.empty()) {
-                if (pretty) {
-                    output += "\n";
-                }
-                
-                for (size_t i = 0; i < arr.size(); ++i) {
-                    if (pretty) {
-                        printIndent(output, currentIndent + indent);
-                    }
+    std::vector<PrintFrame> stack;
+    const JsonValue* next = &value;
+    int nextIndent = currentIndent;
+    
+    while (true) {
+        if (next) {
+            switch (next->getType()) {
+                case ValueType::NULL_TYPE:
+                    output += "null";
+                    break;
                     
-                    printValue(arr[i], output, pretty, indent, currentIndent + indent);
+                case ValueType::BOOLEAN:
+                    output += next->asBool() ? "true" : "false";
+                    break;
                     
-                    if (i < arr.size() - 1) {
-                        output += ",";
-                    }
-                    
-                    if (pretty) {
-                        output += "\n";
-                    }
-                }
-                
-                if (pretty) {
-                    printIndent(output, currentIndent);
-                }
-            }
-            
-            output += "]";
-            break;
-        }
-            
-        case ValueType::OBJECT: {
-            output += "{";
-            const auto& obj = value.getObject();
-            
-            if (!obj.empty()) {
-                if (pretty) {
-                    output += "\n";
+                case ValueType::NUMBER: {
+                    std::ostringstream oss;
+                    oss << next->asNumber();
+                    output += oss.str();
+                    break;
                 }
-                
-                size_t i = 0;
-                for (const auto& pair : obj) {
-                    if (pretty) {
-                        printIndent(output, currentIndent + indent);
-                    }
-                    
-                    output += "\"" + escapeString(pair.first) + "\":";
                     
-                    if (pretty) {
-                        output += " ";
-                    }
+                case ValueType::STRING:
+                    output += "\"" + escapeString(next->asString()) + "\"";
+                    break;
                     
-                    printValue(pair.second, output, pretty, indent, currentIndent + indent);
+                case ValueType::ARRAY:
+                    output += "[";
+                    stack.push_back(PrintFrame{next, 0, {}, nextIndent});
+                    break;
                     
-                    if (i < obj.size() - 1) {
-                        output += ",";
-                    }
-                    
-                    if (pretty) {
-                        output += "\n";
-                    }
-                    
-                    ++i;
-                }
-                
-                if (pretty) {
-                    printIndent(output, currentIndent);
-                }
+                case ValueType::OBJECT:
+                    output += "{";
+                    stack.push_back(PrintFrame{next, 0, next->getObject().begin(), nextIndent});
+                    break;
+            }
+            next = nullptr;
+        }
+        
+        if (stack.empty()) {
+            return;
+        }
+        
+        PrintFrame& frame = stack.back();
+        bool isArray = frame.container->isArray();
+        size_t count = frame.container->size();
+        
+        if (frame.index == count) {
+            if (count > 0 && pretty) {
+                output += "\n";
+                printIndent(output, frame.indent);
+            }
+            output += isArray ? "]" : "}";
+            stack.pop_back();
+            continue;
+        }
+        
+        if (frame.index > 0) {
+            output += ",";
+        }
+        if (pretty) {
+            output += "\n";
+            printIndent(output, frame.indent + indent);
+        }
+        
+        if (isArray) {
+            next = &frame.container->getArray()[frame.index];
+        } else {
+            output += "\"" + escapeString(frame.member->first) + "\":";
+            if (pretty) {
+                output += " ";
             }
-            
-            output += "}";
-            break;
+            next = &frame.member->second;
+            ++frame.member;
         }
+        ++frame.index;
+        nextIndent = frame.indent + indent;
     }
 }
 
@@ -118,7 +122,7 @@ std::string JsonPrinter::escapeString(const std::string& str) {
     for (char c : str) {
         switch (c) {
             case '"': escaped += "\\\""; break;
-            case '\': escaped += "\\\\"; break;
+            case '\\': escaped += "\\\\"; break;
             case '\b': escaped += "\\b"; break;
             case '\f': escaped += "\\f"; break;
             case '\n': escaped += "\\n"; break;
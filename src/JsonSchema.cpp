@@ -0,0 +1,587 @@
+#include "JsonSchema.h"
+#include "JsonCursor.h"
+#include "JsonPattern.h"
+#include "JsonPointer.h"
+#include "JsonPrinter.h"
+#include "JsonStats.h"
+#include <algorithm>
+#include <cmath>
+#include <istream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace json {
+
+namespace {
+
+using Path = std::vector<std::string>;
+
+constexpr size_t kNone = static_cast<size_t>(-1);
+
+// Type bits. "integer" is its own bit because it only matches numbers with
+// no fractional part.
+constexpr unsigned kNullBit = 1u << 0;
+constexpr unsigned kBooleanBit = 1u << 1;
+constexpr unsigned kNumberBit = 1u << 2;
+constexpr unsigned kStringBit = 1u << 3;
+constexpr unsigned kArrayBit = 1u << 4;
+constexpr unsigned kObjectBit = 1u << 5;
+constexpr unsigned kIntegerBit = 1u << 6;
+constexpr unsigned kAnyType = kNullBit | kBooleanBit | kNumberBit | kStringBit | kArrayBit | kObjectBit;
+
+const std::pair<const char*, unsigned> kTypeNames[] = {
+    {"null", kNullBit}, {"boolean", kBooleanBit}, {"number", kNumberBit}, {"integer", kIntegerBit},
+    {"string", kStringBit}, {"array", kArrayBit}, {"object", kObjectBit},
+};
+
+// Keywords whose absence of support would silently accept invalid input.
+const char* const kUnsupportedKeywords[] = {
+    "$ref", "$dynamicRef", "allOf", "anyOf", "oneOf", "not", "if", "then", "else",
+    "prefixItems", "contains", "minContains", "maxContains", "patternProperties",
+    "propertyNames", "dependentSchemas", "dependentRequired", "unevaluatedItems",
+    "unevaluatedProperties", "uniqueItems", "multipleOf",
+};
+
+} // namespace
+
+struct SchemaProperty {
+    std::string key;
+    size_t schema;        // kNone when the name only appears in `required`
+    bool required;
+};
+
+struct SchemaNode {
+    bool reject = false;  // the `false` schema
+    unsigned types = kAnyType;
+
+    std::vector<JsonValue> allowed;  // enum / const values
+    const char* allowedKeyword = nullptr;
+
+    std::optional<double> minimum;
+    std::optional<double> exclusiveMinimum;
+    std::optional<double> maximum;
+    std::optional<double> exclusiveMaximum;
+
+    size_t minLength = 0;
+    size_t maxLength = kNone;
+    std::optional<JsonPattern> pattern;
+
+    size_t minItems = 0;
+    size_t maxItems = kNone;
+    size_t items = kNone;
+
+    size_t minProperties = 0;
+    size_t maxProperties = kNone;
+    std::vector<SchemaProperty> properties;  // sorted by key
+    size_t additionalProperties = kNone;
+
+    // Schema that applies to the member `key`, or kNone when it is unconstrained.
+    size_t memberSchema(const std::string& key) const {
+        auto it = std::lower_bound(properties.begin(), properties.end(), key,
+                                   [](const SchemaProperty& p, const std::string& k) { return p.key < k; });
+        if (it != properties.end() && it->key == key && it->schema != kNone) {
+            return it->schema;
+        }
+        return additionalProperties;
+    }
+};
+
+struct SchemaTables {
+    std::vector<SchemaNode> nodes;  // nodes[0] is the root schema
+};
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// Compilation
+
+class SchemaCompiler {
+public:
+    explicit SchemaCompiler(SchemaTables& tables) : tables_(tables) {}
+
+    void compile(const JsonValue& schema) {
+        addNode(schema, Path());
+        while (!pending_.empty()) {
+            Pending item = std::move(pending_.back());
+            pending_.pop_back();
+            compileNode(item);
+        }
+    }
+
+private:
+    struct Pending {
+        const JsonValue* schema;
+        size_t node;
+        Path path;
+    };
+
+    size_t addNode(const JsonValue& schema, Path path) {
+        size_t index = tables_.nodes.size();
+        tables_.nodes.emplace_back();
+        pending_.push_back(Pending{&schema, index, std::move(path)});
+        return index;
+    }
+
+    size_t addChild(const JsonValue& schema, const Path& path, const std::string& keyword) {
+        Path child = path;
+        child.push_back(keyword);
+        return addNode(schema, std::move(child));
+    }
+
+    [[noreturn]] static void invalid(const Path& path, const std::string& message) {
+        throw std::runtime_error("Invalid schema at " + (path.empty() ? std::string("root") : joinPointer(path)) +
+                                 ": " + message);
+    }
+
+    static double number(const JsonValue& value, const Path& path, const std::string& keyword) {
+        if (!value.isNumber()) invalid(path, "'" + keyword + "' must be a number");
+        return value.asNumber();
+    }
+
+    static size_t count(const JsonValue& value, const Path& path, const std::string& keyword) {
+        if (!value.isNumber() || value.asNumber() < 0 || std::floor(value.asNumber()) != value.asNumber()) {
+            invalid(path, "'" + keyword + "' must be a non-negative integer");
+        }
+        // No length can reach a bound beyond size_t, so such bounds saturate.
+        if (value.asNumber() >= static_cast<double>(std::numeric_limits<size_t>::max())) {
+            return std::numeric_limits<size_t>::max();
+        }
+        return static_cast<size_t>(value.asNumber());
+    }
+
+    static unsigned typeBit(const JsonValue& name, const Path& path) {
+        if (name.isString()) {
+            for (const auto& entry : kTypeNames) {
+                if (name.asString() == entry.first) return entry.second;
+            }
+        }
+        invalid(path, "unknown type " + JsonPrinter::print(name));
+    }
+
+    void compileNode(const Pending& item) {
+        const JsonValue& schema = *item.schema;
+        const Path& path = item.path;
+        SchemaNode node;
+
+        if (schema.isBool()) {
+            node.reject = !schema.asBool();
+            tables_.nodes[item.node] = std::move(node);
+            return;
+        }
+        if (!schema.isObject()) invalid(path, "a schema must be an object or a boolean");
+
+        for (const char* keyword : kUnsupportedKeywords) {
+            if (schema.hasKey(keyword)) invalid(path, std::string("unsupported keyword '") + keyword + "'");
+        }
+
+        if (const JsonValue* type = schema.find("type")) {
+            node.types = 0;
+            if (type->isArray()) {
+                for (const JsonValue& name : type->getArray()) node.types |= typeBit(name, path);
+            } else {
+                node.types = typeBit(*type, path);
+            }
+            if (node.types & kNumberBit) node.types &= ~kIntegerBit;
+        }
+
+        if (const JsonValue* values = schema.find("enum")) {
+            if (!values->isArray()) invalid(path, "'enum' must be an array");
+            node.allowed = values->getArray();
+            node.allowedKeyword = "enum";
+        }
+        if (const JsonValue* value = schema.find("const")) {
+            if (node.allowedKeyword) {
+                // Both present: only values satisfying each may pass.
+                bool listed = std::find(node.allowed.begin(), node.allowed.end(), *value) != node.allowed.end();
+                node.allowed.clear();
+                if (listed) node.allowed.push_back(*value);
+            } else {
+                node.allowed.push_back(*value);
+            }
+            node.allowedKeyword = "const";
+        }
+
+        if (const JsonValue* v = schema.find("minimum")) node.minimum = number(*v, path, "minimum");
+        if (const JsonValue* v = schema.find("exclusiveMinimum")) node.exclusiveMinimum = number(*v, path, "exclusiveMinimum");
+        if (const JsonValue* v = schema.find("maximum")) node.maximum = number(*v, path, "maximum");
+        if (const JsonValue* v = schema.find("exclusiveMaximum")) node.exclusiveMaximum = number(*v, path, "exclusiveMaximum");
+        if (const JsonValue* v = schema.find("minLength")) node.minLength = count(*v, path, "minLength");
+        if (const JsonValue* v = schema.find("maxLength")) node.maxLength = count(*v, path, "maxLength");
+        if (const JsonValue* v = schema.find("minItems")) node.minItems = count(*v, path, "minItems");
+        if (const JsonValue* v = schema.find("maxItems")) node.maxItems = count(*v, path, "maxItems");
+        if (const JsonValue* v = schema.find("minProperties")) node.minProperties = count(*v, path, "minProperties");
+        if (const JsonValue* v = schema.find("maxProperties")) node.maxProperties = count(*v, path, "maxProperties");
+
+        if (const JsonValue* pattern = schema.find("pattern")) {
+            if (!pattern->isString()) invalid(path, "'pattern' must be a string");
+            try {
+                node.pattern.emplace(pattern->asString());
+            } catch (const std::runtime_error& e) {
+                invalid(path, "invalid pattern '" + pattern->asString() + "': " + e.what());
+            }
+        }
+
+        if (const JsonValue* items = schema.find("items")) {
+            if (items->isArray()) invalid(path, "'items' must be a schema; tuple validation uses prefixItems");
+            node.items = addChild(*items, path, "items");
+        }
+
+        if (const JsonValue* properties = schema.find("properties")) {
+            if (!properties->isObject()) invalid(path, "'properties' must be an object");
+            Path propertiesPath = path;
+            propertiesPath.push_back("properties");
+            for (const auto& [key, subschema] : properties->getObject()) {
+                node.properties.push_back(SchemaProperty{key, addChild(subschema, propertiesPath, key), false});
+            }
+        }
+
+        if (const JsonValue* required = schema.find("required")) {
+            if (!required->isArray()) invalid(path, "'required' must be an array");
+            for (const JsonValue& name : required->getArray()) {
+                if (!name.isString()) invalid(path, "'required' must contain strings");
+                auto it = std::lower_bound(node.properties.begin(), node.properties.end(), name.asString(),
+                                           [](const SchemaProperty& p, const std::string& k) { return p.key < k; });
+                if (it == node.properties.end() || it->key != name.asString()) {
+                    it = node.properties.insert(it, SchemaProperty{name.asString(), kNone, false});
+                }
+                it->required = true;
+            }
+        }
+
+        if (const JsonValue* additional = schema.find("additionalProperties")) {
+            node.additionalProperties = addChild(*additional, path, "additionalProperties");
+        }
+
+        tables_.nodes[item.node] = std::move(node);
+    }
+
+    SchemaTables& tables_;
+    std::vector<Pending> pending_;
+};
+
+// ---------------------------------------------------------------------------
+// Keyword checks shared by the tree and stream validators. Each returns an
+// error message, or an empty string when the value passes.
+
+const char* typeName(ValueType type) {
+    return Stats::valueTypeName(type);
+}
+
+std::string describeTypes(unsigned types) {
+    std::string names;
+    for (const auto& entry : kTypeNames) {
+        if (!(types & entry.second)) continue;
+        if (!names.empty()) names += " or ";
+        names += entry.first;
+    }
+    return names;
+}
+
+std::string formatNumber(double value) {
+    return JsonPrinter::print(JsonValue(value));
+}
+
+std::string checkType(const SchemaNode& node, ValueType type, double number) {
+    if (node.reject) {
+        return "value is not allowed";
+    }
+    unsigned bit = 0;
+    switch (type) {
+        case ValueType::NULL_TYPE: bit = kNullBit; break;
+        case ValueType::BOOLEAN: bit = kBooleanBit; break;
+        case ValueType::NUMBER: bit = kNumberBit; break;
+        case ValueType::STRING: bit = kStringBit; break;
+        case ValueType::ARRAY: bit = kArrayBit; break;
+        case ValueType::OBJECT: bit = kObjectBit; break;
+    }
+    if (node.types & bit) {
+        return "";
+    }
+    if (bit == kNumberBit && (node.types & kIntegerBit) && std::isfinite(number) && std::floor(number) == number) {
+        return "";
+    }
+    return "expected " + describeTypes(node.types) + ", got " + typeName(type);
+}
+
+std::string checkNumber(const SchemaNode& node, double value) {
+    if (node.minimum && value < *node.minimum) {
+        return formatNumber(value) + " is less than the minimum of " + formatNumber(*node.minimum);
+    }
+    if (node.exclusiveMinimum && value <= *node.exclusiveMinimum) {
+        return formatNumber(value) + " is not greater than " + formatNumber(*node.exclusiveMinimum);
+    }
+    if (node.maximum && value > *node.maximum) {
+        return formatNumber(value) + " is greater than the maximum of " + formatNumber(*node.maximum);
+    }
+    if (node.exclusiveMaximum && value >= *node.exclusiveMaximum) {
+        return formatNumber(value) + " is not less than " + formatNumber(*node.exclusiveMaximum);
+    }
+    return "";
+}
+
+std::string checkString(const SchemaNode& node, const std::string& value) {
+    if (node.minLength > 0 || node.maxLength != kNone) {
+        // Lengths count code points, not bytes.
+        size_t length = 0;
+        for (char c : value) {
+            if ((static_cast<unsigned char>(c) & 0xC0) != 0x80) length++;
+        }
+        if (length < node.minLength) {
+            return "string is shorter than " + std::to_string(node.minLength) + " characters";
+        }
+        if (node.maxLength != kNone && length > node.maxLength) {
+            return "string is longer than " + std::to_string(node.maxLength) + " characters";
+        }
+    }
+    if (node.pattern && !node.pattern->search(value)) {
+        return "string does not match pattern '" + node.pattern->source() + "'";
+    }
+    return "";
+}
+
+std::string checkSize(const SchemaNode& node, ValueType type, size_t size) {
+    if (type == ValueType::ARRAY) {
+        if (size < node.minItems) return "expected at least " + std::to_string(node.minItems) + " items";
+        if (node.maxItems != kNone && size > node.maxItems) {
+            return "expected at most " + std::to_string(node.maxItems) + " items";
+        }
+    } else {
+        if (size < node.minProperties) {
+            return "expected at least " + std::to_string(node.minProperties) + " properties";
+        }
+        if (node.maxProperties != kNone && size > node.maxProperties) {
+            return "expected at most " + std::to_string(node.maxProperties) + " properties";
+        }
+    }
+    return "";
+}
+
+std::string checkAllowed(const SchemaNode& node, const JsonValue& value) {
+    if (!node.allowedKeyword || std::find(node.allowed.begin(), node.allowed.end(), value) != node.allowed.end()) {
+        return "";
+    }
+    return std::string("value does not match '") + node.allowedKeyword + "'";
+}
+
+[[noreturn]] void violation(const Path& path, const std::string& message) {
+    throw std::runtime_error("Schema violation at " + (path.empty() ? std::string("document root") : joinPointer(path)) +
+                             ": " + message);
+}
+
+// ---------------------------------------------------------------------------
+// Validation of a parsed document. Containers are walked with an explicit
+// stack, like the parser and printer, so deep documents are safe.
+
+class TreeValidator {
+public:
+    explicit TreeValidator(const SchemaTables& tables) : nodes_(tables.nodes) {}
+
+    // Checks `root` against nodes_[node]. Returns the path and message of
+    // the first violation, if any.
+    bool run(const JsonValue& root, size_t node, Path& path, std::string& error) {
+        if (!enter(root, node, error)) {
+            path.clear();
+            return false;
+        }
+        while (!stack_.empty()) {
+            Frame& top = stack_.back();
+            const SchemaNode& node = nodes_[top.node];
+            const JsonValue* child = nullptr;
+            size_t childNode = kNone;
+
+            if (top.value->isArray()) {
+                const JsonArray& array = top.value->getArray();
+                if (top.index == array.size()) {
+                    stack_.pop_back();
+                    continue;
+                }
+                child = &array[top.index++];
+                childNode = node.items;
+            } else {
+                if (top.member == top.value->getObject().end()) {
+                    stack_.pop_back();
+                    continue;
+                }
+                child = &top.member->second;
+                childNode = node.memberSchema(top.member->first);
+                top.key = &top.member->first;
+                ++top.member;
+                if (childNode != kNone && nodes_[childNode].reject) {
+                    error = "property is not allowed";
+                    return fail(path);
+                }
+            }
+
+            if (childNode != kNone && !enter(*child, childNode, error)) {
+                return fail(path);
+            }
+        }
+        return true;
+    }
+
+private:
+    using JsonArray = std::vector<JsonValue>;
+
+    struct Frame {
+        const JsonValue* value;
+        size_t node;
+        size_t index;   // next element, for arrays
+        std::map<std::string, JsonValue>::const_iterator member;
+        const std::string* key;  // key of the member being visited
+    };
+
+    // Checks the keywords that apply to `value` itself and queues its
+    // members when the schema constrains them.
+    bool enter(const JsonValue& value, size_t index, std::string& error) {
+        const SchemaNode& node = nodes_[index];
+        ValueType type = value.getType();
+        error = checkType(node, type, type == ValueType::NUMBER ? value.asNumber() : 0.0);
+        if (error.empty()) error = checkAllowed(node, value);
+        if (!error.empty()) return false;
+
+        if (type == ValueType::NUMBER) {
+            error = checkNumber(node, value.asNumber());
+        } else if (type == ValueType::STRING) {
+            error = checkString(node, value.asString());
+        } else if (type == ValueType::ARRAY) {
+            error = checkSize(node, type, value.size());
+            if (error.empty() && node.items != kNone && value.size() > 0) {
+                stack_.push_back(Frame{&value, index, 0, {}, nullptr});
+            }
+        } else if (type == ValueType::OBJECT) {
+            error = checkSize(node, type, value.size());
+            for (size_t i = 0; error.empty() && i < node.properties.size(); ++i) {
+                const SchemaProperty& property = node.properties[i];
+                if (property.required && !value.hasKey(property.key)) {
+                    error = "missing required property '" + property.key + "'";
+                }
+            }
+            if (error.empty() && value.size() > 0 &&
+                (!node.properties.empty() || node.additionalProperties != kNone)) {
+                stack_.push_back(Frame{&value, index, 0, value.getObject().begin(), nullptr});
+            }
+        }
+        return error.empty();
+    }
+
+    bool fail(Path& path) {
+        path.clear();
+        for (const Frame& frame : stack_) {
+            path.push_back(frame.value->isArray() ? std::to_string(frame.index - 1) : *frame.key);
+        }
+        return false;
+    }
+
+    const std::vector<SchemaNode>& nodes_;
+    std::vector<Frame> stack_;
+};
+
+// ---------------------------------------------------------------------------
+// Validation of a top-level array read through a JsonCursor. Each element is
+// built, checked against the `items` schema and dropped, so memory is bounded
+// by the largest element rather than the document.
+
+class StreamValidator {
+public:
+    explicit StreamValidator(const SchemaTables& tables) : tables_(tables), root_(tables.nodes[0]) {}
+
+    void run(JsonCursor& cursor) {
+        std::string error = checkType(root_, ValueType::ARRAY, 0.0);
+        if (!error.empty()) violation({}, error);
+
+        // The tree validator checks the array's size before its elements, so
+        // a bad element only settles the outcome once the size cannot fail.
+        size_t count = 0;
+        std::optional<std::pair<Path, std::string>> elementError;
+        while (cursor.next()) {
+            if (++count > root_.maxItems) break;
+            if (elementError || root_.items == kNone) {
+                cursor.skip();
+                continue;
+            }
+            Path path;
+            if (!TreeValidator(tables_).run(cursor.readValue(), root_.items, path, error)) {
+                path.insert(path.begin(), std::to_string(cursor.index()));
+                if (root_.maxItems == kNone && count >= root_.minItems) violation(path, error);
+                elementError.emplace(std::move(path), std::move(error));
+            }
+        }
+
+        error = checkSize(root_, ValueType::ARRAY, count);
+        if (!error.empty()) violation({}, error);
+        if (elementError) violation(elementError->first, elementError->second);
+    }
+
+private:
+    const SchemaTables& tables_;
+    const SchemaNode& root_;
+};
+
+// Exposes a string to the streaming parser in place. The string constructor
+// of JsonLexer would copy the whole input first.
+class StringSource : public std::streambuf {
+public:
+    explicit StringSource(const std::string& text) {
+        char* begin = const_cast<char*>(text.data());  // the get area is never written
+        setg(begin, begin, begin + text.size());
+    }
+};
+
+} // namespace
+
+JsonSchema::JsonSchema(const JsonValue& schema) {
+    auto tables = std::make_shared<SchemaTables>();
+    SchemaCompiler(*tables).compile(schema);
+    tables_ = std::move(tables);
+}
+
+JsonSchema JsonSchema::fromFile(const std::string& filename, const ParseOptions& options) {
+    return JsonSchema(JsonParser::parseFile(filename, options));
+}
+
+bool JsonSchema::isValid(const JsonValue& value) const {
+    Path path;
+    std::string error;
+    return TreeValidator(*tables_).run(value, 0, path, error);
+}
+
+void JsonSchema::validate(const JsonValue& value) const {
+    Path path;
+    std::string error;
+    if (!TreeValidator(*tables_).run(value, 0, path, error)) {
+        violation(path, error);
+    }
+}
+
+JsonValue JsonSchema::parse(const std::string& input, const ParseOptions& options) const {
+    JsonValue document = JsonParser(input, options).parse();
+    validate(document);
+    return document;
+}
+
+JsonValue JsonSchema::parse(std::istream& input, const ParseOptions& options) const {
+    JsonValue document = JsonParser(input, options).parse();
+    validate(document);
+    return document;
+}
+
+void JsonSchema::validateStream(std::istream& input, const ParseOptions& options) const {
+    JsonCursor cursor(input, options);
+    // enum and const compare the whole root, so it has to be built.
+    if (tables_->nodes[0].allowedKeyword || !cursor.isArray()) {
+        validate(cursor.readDocument());
+        return;
+    }
+    StreamValidator(*tables_).run(cursor);
+}
+
+void JsonSchema::validateStream(const std::string& input, const ParseOptions& options) const {
+    StringSource source(input);
+    std::istream stream(&source);
+    validateStream(stream, options);
+}
+
+} // namespace json
@@ -0,0 +1,67 @@
+#include "JsonStatic.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace json {
+
+namespace {
+
+struct ConvertFrame {
+    StaticJson source;
+    JsonValue value;
+    size_t next;    // next member of `source` to convert
+};
+
+JsonValue convertScalar(const StaticJson& source) {
+    switch (source.getType()) {
+        case ValueType::BOOLEAN: return JsonValue(source.asBool());
+        case ValueType::NUMBER: return JsonValue(source.asNumber());
+        case ValueType::STRING: return JsonValue(std::string(source.asString()));
+        case ValueType::ARRAY: return JsonValue::makeArray();
+        case ValueType::OBJECT: return JsonValue::makeObject();
+        case ValueType::NULL_TYPE: break;
+    }
+    return JsonValue();
+}
+
+} // namespace
+
+JsonValue StaticJson::toJsonValue() const {
+    if (!isArray() && !isObject()) {
+        return convertScalar(*this);
+    }
+
+    std::vector<ConvertFrame> stack;
+    stack.push_back({*this, convertScalar(*this), 0});
+
+    while (true) {
+        ConvertFrame& frame = stack.back();
+        if (frame.next < frame.source.size()) {
+            size_t index = frame.next++;
+            StaticJson member = frame.source.child(index);
+            if (member.isArray() || member.isObject()) {
+                stack.push_back({member, convertScalar(member), 0});
+            } else if (frame.source.isObject()) {
+                frame.value.set(std::string(member.key()), convertScalar(member));
+            } else {
+                frame.value.push_back(convertScalar(member));
+            }
+            continue;
+        }
+
+        ConvertFrame done = std::move(stack.back());
+        stack.pop_back();
+        if (stack.empty()) {
+            return std::move(done.value);
+        }
+        ConvertFrame& parent = stack.back();
+        if (parent.source.isObject()) {
+            parent.value.set(std::string(done.source.key()), std::move(done.value));
+        } else {
+            parent.value.push_back(std::move(done.value));
+        }
+    }
+}
+
+} // namespace json
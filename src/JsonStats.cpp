@@ -0,0 +1,126 @@
+#include "JsonStats.h"
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+
+namespace json {
+
+namespace {
+
+std::atomic<bool> statsEnabled{false};
+
+thread_local ParseStats threadStats;
+
+double toMillis(std::chrono::nanoseconds d) {
+    return std::chrono::duration<double, std::milli>(d).count();
+}
+
+} // namespace
+
+ParseStats& ParseStats::operator+=(const ParseStats& other) {
+    lexTime += other.lexTime;
+    parseTime += other.parseTime;
+    printTime += other.printTime;
+    bytesLexed += other.bytesLexed;
+    bytesPrinted += other.bytesPrinted;
+    for (size_t i = 0; i < kTokenTypeCount; ++i) {
+        tokens[i] += other.tokens[i];
+    }
+    for (size_t i = 0; i < kValueTypeCount; ++i) {
+        values[i] += other.values[i];
+    }
+    allocations += other.allocations;
+    maxDepth = std::max(maxDepth, other.maxDepth);
+    peakDocumentBytes = std::max(peakDocumentBytes, other.peakDocumentBytes);
+    return *this;
+}
+
+bool Stats::compiledIn() {
+#ifdef JSON_ENABLE_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Stats::setEnabled(bool enabled) {
+    statsEnabled.store(enabled && compiledIn(), std::memory_order_relaxed);
+}
+
+bool Stats::enabled() {
+    return statsEnabled.load(std::memory_order_relaxed);
+}
+
+ParseStats& Stats::current() {
+    return threadStats;
+}
+
+void Stats::reset() {
+    threadStats = ParseStats();
+}
+
+void Stats::report(std::ostream& out, const ParseStats& stats) {
+    if (!compiledIn()) {
+        out << "Stats: not available (built without JSON_ENABLE_STATS)\n";
+        return;
+    }
+
+    out << std::fixed << std::setprecision(3);
+    out << "Stats:\n";
+    out << "  lex time:        " << toMillis(stats.lexTime) << " ms\n";
+    out << "  parse time:      " << toMillis(stats.parseTime) << " ms\n";
+    out << "  print time:      " << toMillis(stats.printTime) << " ms\n";
+    out << "  bytes lexed:     " << stats.bytesLexed << "\n";
+    out << "  bytes printed:   " << stats.bytesPrinted << "\n";
+    out << "  allocations:     " << stats.allocations << "\n";
+    out << "  max depth:       " << stats.maxDepth << "\n";
+    out << "  peak doc memory: " << stats.peakDocumentBytes << " bytes\n";
+
+    out << "  tokens:\n";
+    for (size_t i = 0; i < kTokenTypeCount; ++i) {
+        if (stats.tokens[i] == 0) continue;
+        out << "    " << std::left << std::setw(15) << tokenTypeName(static_cast<TokenType>(i))
+            << std::right << stats.tokens[i] << "\n";
+    }
+
+    out << "  values:\n";
+    for (size_t i = 0; i < kValueTypeCount; ++i) {
+        if (stats.values[i] == 0) continue;
+        out << "    " << std::left << std::setw(15) << valueTypeName(static_cast<ValueType>(i))
+            << std::right << stats.values[i] << "\n";
+    }
+    out << std::defaultfloat;
+}
+
+const char* Stats::tokenTypeName(TokenType type) {
+    switch (type) {
+        case TokenType::LEFT_BRACE: return "LEFT_BRACE";
+        case TokenType::RIGHT_BRACE: return "RIGHT_BRACE";
+        case TokenType::LEFT_BRACKET: return "LEFT_BRACKET";
+        case TokenType::RIGHT_BRACKET: return "RIGHT_BRACKET";
+        case TokenType::COLON: return "COLON";
+        case TokenType::COMMA: return "COMMA";
+        case TokenType::STRING: return "STRING";
+        case TokenType::NUMBER: return "NUMBER";
+        case TokenType::TRUE: return "TRUE";
+        case TokenType::FALSE: return "FALSE";
+        case TokenType::NULL_TOKEN: return "NULL";
+        case TokenType::END_OF_FILE: return "END_OF_FILE";
+        case TokenType::INVALID: return "INVALID";
+    }
+    return "UNKNOWN";
+}
+
+const char* Stats::valueTypeName(ValueType type) {
+    switch (type) {
+        case ValueType::NULL_TYPE: return "null";
+        case ValueType::BOOLEAN: return "boolean";
+        case ValueType::NUMBER: return "number";
+        case ValueType::STRING: return "string";
+        case ValueType::ARRAY: return "array";
+        case ValueType::OBJECT: return "object";
+    }
+    return "unknown";
+}
+
+} // namespace json
@@ -1,16 +1,169 @@
 #include "JsonValue.h"
+#include <atomic>
 
 namespace json {
 
-JsonValue::JsonValue() : type_(ValueType::NULL_TYPE), boolValue_(false), numberValue_(0.0) {}
+namespace {
 
-JsonValue::JsonValue(bool value) : type_(ValueType::BOOLEAN), boolValue_(value), numberValue_(0.0) {}
+// use_count() is a relaxed load. Once it reads 1 the other copies are gone,
+// and the fence orders their last reads (released by the shared_ptr count
+// decrement) before this thread writes or frees the payload in place.
+template <typename Payload>
+bool ownsExclusively(const std::shared_ptr<Payload>& payload) {
+    if (payload.use_count() != 1) {
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return true;
+}
+
+} // namespace
+
+JsonValue::JsonValue() : type_(ValueType::NULL_TYPE), boolValue_(false), leaked_(false), numberValue_(0.0) {}
+
+JsonValue::JsonValue(bool value) : type_(ValueType::BOOLEAN), boolValue_(value), leaked_(false), numberValue_(0.0) {}
+
+JsonValue::JsonValue(double value) : type_(ValueType::NUMBER), boolValue_(false), leaked_(false), numberValue_(value) {}
+
+JsonValue::JsonValue(const std::string& value) : type_(ValueType::STRING), boolValue_(false), leaked_(false), numberValue_(0.0), stringValue_(value) {}
+
+JsonValue::JsonValue(const char* value) : type_(ValueType::STRING), boolValue_(false), leaked_(false), numberValue_(0.0), stringValue_(value) {}
+
+JsonValue::JsonValue(const JsonValue& other)
+    : type_(other.type_), boolValue_(other.boolValue_), leaked_(false), numberValue_(other.numberValue_),
+      stringValue_(other.stringValue_), arrayValue_(other.arrayValue_), objectValue_(other.objectValue_) {
+    // Someone may still write through a reference into other's payload, so
+    // it cannot be shared. Its children are copied the same way.
+    if (other.leaked_) {
+        clonePayloads(*this, other);
+    }
+}
 
-JsonValue::JsonValue(double value) : type_(ValueType::NUMBER), boolValue_(false), numberValue_(value) {}
+void JsonValue::shareFrom(const JsonValue& other) {
+    type_ = other.type_;
+    boolValue_ = other.boolValue_;
+    numberValue_ = other.numberValue_;
+    stringValue_ = other.stringValue_;
+    arrayValue_ = other.arrayValue_;
+    objectValue_ = other.objectValue_;
+}
 
-JsonValue::JsonValue(const std::string& value) : type_(ValueType::STRING), boolValue_(false), numberValue_(0.0), stringValue_(value) {}
+// Gives `target` its own copy of source's top-level payload. Children share
+// their payloads, except leaked ones, which are cloned in turn. An explicit
+// worklist keeps a deep chain of leaked containers from recursing.
+void JsonValue::clonePayloads(JsonValue& target, const JsonValue& source) {
+    std::vector<std::pair<JsonValue*, const JsonValue*>> pending;
+    pending.emplace_back(&target, &source);
+    
+    while (!pending.empty()) {
+        JsonValue& copy = *pending.back().first;
+        const JsonValue& original = *pending.back().second;
+        pending.pop_back();
+        
+        if (original.arrayValue_) {
+            const Array& elements = *original.arrayValue_;
+            auto array = std::make_shared<Array>(elements.size());
+            for (size_t i = 0; i < elements.size(); ++i) {
+                (*array)[i].shareFrom(elements[i]);
+                if (elements[i].leaked_) {
+                    pending.emplace_back(&(*array)[i], &elements[i]);
+                }
+            }
+            copy.arrayValue_ = std::move(array);
+        }
+        if (original.objectValue_) {
+            auto object = std::make_shared<Object>();
+            for (const auto& pair : *original.objectValue_) {
+                JsonValue& member = object->emplace_hint(object->end(), pair.first, JsonValue())->second;
+                member.shareFrom(pair.second);
+                if (pair.second.leaked_) {
+                    pending.emplace_back(&member, &pair.second);
+                }
+            }
+            copy.objectValue_ = std::move(object);
+        }
+    }
+}
 
-JsonValue::JsonValue(const char* value) : type_(ValueType::STRING), boolValue_(false), numberValue_(0.0), stringValue_(value) {}
+JsonValue& JsonValue::operator=(const JsonValue& other) {
+    if (this != &other) {
+        *this = JsonValue(other);
+    }
+    return *this;
+}
+
+// Nested containers are unlinked onto a heap-allocated worklist before they
+// are destroyed, so tearing down a deeply nested document never recurses.
+// Payloads still shared with another copy are simply released.
+JsonValue::~JsonValue() {
+    if (!ownsNestedChildren()) {
+        return;
+    }
+    
+    std::vector<JsonValue> pending;
+    detachNestedChildren(pending);
+    while (!pending.empty()) {
+        JsonValue value = std::move(pending.back());
+        pending.pop_back();
+        value.detachNestedChildren(pending);
+    }
+}
+
+bool JsonValue::ownsNestedChildren() const {
+    return (arrayValue_ && !arrayValue_->empty() && ownsExclusively(arrayValue_)) ||
+           (objectValue_ && !objectValue_->empty() && ownsExclusively(objectValue_));
+}
+
+void JsonValue::detachNestedChildren(std::vector<JsonValue>& pending) {
+    if (arrayValue_ && ownsExclusively(arrayValue_)) {
+        for (auto& element : *arrayValue_) {
+            if (element.ownsNestedChildren()) {
+                pending.push_back(std::move(element));
+            }
+        }
+    }
+    if (objectValue_ && ownsExclusively(objectValue_)) {
+        for (auto& pair : *objectValue_) {
+            if (pair.second.ownsNestedChildren()) {
+                pending.push_back(std::move(pair.second));
+            }
+        }
+    }
+    arrayValue_.reset();
+    objectValue_.reset();
+}
+
+// Returns a payload this value owns exclusively, cloning it if it is shared.
+// `leak` records that the caller may keep a mutable reference into it.
+JsonValue::Array& JsonValue::mutableArray(bool leak) {
+    if (type_ != ValueType::ARRAY) {
+        throw std::runtime_error("JsonValue is not an array");
+    }
+    if (!arrayValue_) {
+        arrayValue_ = std::make_shared<Array>();
+    } else if (!ownsExclusively(arrayValue_)) {
+        JsonValue shared;
+        shared.shareFrom(*this);   // keeps the old payload alive while it is copied
+        clonePayloads(*this, shared);
+    }
+    leaked_ = leaked_ || leak;
+    return *arrayValue_;
+}
+
+JsonValue::Object& JsonValue::mutableObject(bool leak) {
+    if (type_ != ValueType::OBJECT) {
+        throw std::runtime_error("JsonValue is not an object");
+    }
+    if (!objectValue_) {
+        objectValue_ = std::make_shared<Object>();
+    } else if (!ownsExclusively(objectValue_)) {
+        JsonValue shared;
+        shared.shareFrom(*this);   // keeps the old payload alive while it is copied
+        clonePayloads(*this, shared);
+    }
+    leaked_ = leaked_ || leak;
+    return *objectValue_;
+}
 
 JsonValue JsonValue::makeNull() {
     return JsonValue();
@@ -51,9 +204,9 @@ const std::string& JsonValue::asString() const {
 
 size_t JsonValue::size() const {
     if (type_ == ValueType::ARRAY) {
-        return arrayValue_.size();
+        return arrayValue_ ? arrayValue_->size() : 0;
     } else if (type_ == ValueType::OBJECT) {
-        return objectValue_.size();
+        return objectValue_ ? objectValue_->size() : 0;
     }
     throw std::runtime_error("JsonValue is not an array or object");
 }
@@ -62,66 +215,186 @@ JsonValue& JsonValue::operator[](size_t index) {
     if (type_ != ValueType::ARRAY) {
         throw std::runtime_error("JsonValue is not an array");
     }
-    if (index >= arrayValue_.size()) {
+    if (index >= size()) {
         throw std::out_of_range("Array index out of range");
     }
-    return arrayValue_[index];
+    return mutableArray(true)[index];
 }
 
 const JsonValue& JsonValue::operator[](size_t index) const {
-    if (type_ != ValueType::ARRAY) {
-        throw std::runtime_error("JsonValue is not an array");
-    }
-    if (index >= arrayValue_.size()) {
+    const Array& array = getArray();
+    if (index >= array.size()) {
         throw std::out_of_range("Array index out of range");
     }
-    return arrayValue_[index];
+    return array[index];
 }
 
 JsonValue& JsonValue::operator[](const std::string& key) {
-    if (type_ != ValueType::OBJECT) {
-        throw std::runtime_error("JsonValue is not an object");
-    }
-    return objectValue_[key];
+    return mutableObject(true)[key];
 }
 
 const JsonValue& JsonValue::operator[](const std::string& key) const {
-    if (type_ != ValueType::OBJECT) {
-        throw std::runtime_error("JsonValue is not an object");
-    }
-    auto it = objectValue_.find(key);
-    if (it == objectValue_.end()) {
+    const Object& object = getObject();
+    auto it = object.find(key);
+    if (it == object.end()) {
         throw std::out_of_range("Key not found in object: " + key);
     }
     return it->second;
 }
 
 void JsonValue::push_back(const JsonValue& value) {
+    mutableArray(false).push_back(value);
+}
+
+void JsonValue::push_back(JsonValue&& value) {
+    mutableArray(false).push_back(std::move(value));
+}
+
+void JsonValue::set(const std::string& key, JsonValue&& value) {
+    mutableObject(false)[key] = std::move(value);
+}
+
+bool JsonValue::hasKey(const std::string& key) const {
+    return find(key) != nullptr;
+}
+
+JsonValue* JsonValue::find(const std::string& key) {
+    if (!hasKey(key)) {
+        return nullptr;
+    }
+    return &mutableObject(true).find(key)->second;
+}
+
+const JsonValue* JsonValue::find(const std::string& key) const {
+    if (type_ != ValueType::OBJECT || !objectValue_) {
+        return nullptr;
+    }
+    auto it = objectValue_->find(key);
+    return it == objectValue_->end() ? nullptr : &it->second;
+}
+
+void JsonValue::insert(size_t index, JsonValue&& value) {
+    Array& array = mutableArray(false);
+    if (index > array.size()) {
+        throw std::out_of_range("Array index out of range");
+    }
+    array.insert(array.begin() + static_cast<std::ptrdiff_t>(index), std::move(value));
+}
+
+JsonValue JsonValue::erase(size_t index) {
     if (type_ != ValueType::ARRAY) {
         throw std::runtime_error("JsonValue is not an array");
     }
-    arrayValue_.push_back(value);
+    if (index >= size()) {
+        throw std::out_of_range("Array index out of range");
+    }
+    Array& array = mutableArray(false);
+    auto it = array.begin() + static_cast<std::ptrdiff_t>(index);
+    JsonValue removed = std::move(*it);
+    array.erase(it);
+    return removed;
 }
 
-bool JsonValue::hasKey(const std::string& key) const {
+JsonValue JsonValue::erase(const std::string& key) {
     if (type_ != ValueType::OBJECT) {
-        return false;
+        throw std::runtime_error("JsonValue is not an object");
+    }
+    if (!hasKey(key)) {
+        throw std::out_of_range("Key not found in object: " + key);
     }
-    return objectValue_.find(key) != objectValue_.end();
+    Object& object = mutableObject(false);
+    auto it = object.find(key);
+    JsonValue removed = std::move(it->second);
+    object.erase(it);
+    return removed;
 }
 
 const std::vector<JsonValue>& JsonValue::getArray() const {
+    static const Array empty;
     if (type_ != ValueType::ARRAY) {
         throw std::runtime_error("JsonValue is not an array");
     }
-    return arrayValue_;
+    return arrayValue_ ? *arrayValue_ : empty;
 }
 
 const std::map<std::string, JsonValue>& JsonValue::getObject() const {
+    static const Object empty;
     if (type_ != ValueType::OBJECT) {
         throw std::runtime_error("JsonValue is not an object");
     }
-    return objectValue_;
+    return objectValue_ ? *objectValue_ : empty;
+}
+
+JsonValue* detail::JsonValueAccess::find(JsonValue& value, const std::string& key) {
+    if (!value.hasKey(key)) {
+        return nullptr;
+    }
+    return &value.mutableObject(false).find(key)->second;
+}
+
+JsonValue& detail::JsonValueAccess::at(JsonValue& value, size_t index) {
+    if (value.type_ != ValueType::ARRAY) {
+        throw std::runtime_error("JsonValue is not an array");
+    }
+    if (index >= value.size()) {
+        throw std::out_of_range("Array index out of range");
+    }
+    return value.mutableArray(false)[index];
+}
+
+// Compares structurally using an explicit worklist, so deeply nested
+// documents do not recurse. Shared payloads compare equal without a walk.
+bool JsonValue::operator==(const JsonValue& other) const {
+    std::vector<std::pair<const JsonValue*, const JsonValue*>> pending;
+    pending.emplace_back(this, &other);
+    
+    while (!pending.empty()) {
+        const JsonValue& a = *pending.back().first;
+        const JsonValue& b = *pending.back().second;
+        pending.pop_back();
+        
+        if (a.type_ != b.type_) {
+            return false;
+        }
+        
+        switch (a.type_) {
+            case ValueType::NULL_TYPE:
+                break;
+            case ValueType::BOOLEAN:
+                if (a.boolValue_ != b.boolValue_) return false;
+                break;
+            case ValueType::NUMBER:
+                if (a.numberValue_ != b.numberValue_) return false;
+                break;
+            case ValueType::STRING:
+                if (a.stringValue_ != b.stringValue_) return false;
+                break;
+            case ValueType::ARRAY: {
+                if (a.arrayValue_ == b.arrayValue_) break;
+                const Array& left = a.getArray();
+                const Array& right = b.getArray();
+                if (left.size() != right.size()) return false;
+                for (size_t i = 0; i < left.size(); ++i) {
+                    pending.emplace_back(&left[i], &right[i]);
+                }
+                break;
+            }
+            case ValueType::OBJECT: {
+                if (a.objectValue_ == b.objectValue_) break;
+                const Object& left = a.getObject();
+                const Object& right = b.getObject();
+                if (left.size() != right.size()) return false;
+                auto it = right.begin();
+                for (const auto& pair : left) {
+                    if (pair.first != it->first) return false;
+                    pending.emplace_back(&pair.second, &it->second);
+                    ++it;
+                }
+                break;
+            }
+        }
+    }
+    return true;
 }
 
 } // namespace json
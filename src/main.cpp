@@ -1,7 +1,16 @@
 #include "JsonParser.h"
 #include "JsonPrinter.h"
+#include "JsonDiff.h"
+#include "JsonPatch.h"
+#include "JsonBatch.h"
+#include "JsonSchema.h"
+#include "JsonStats.h"
+#include <algorithm>
 #include <iostream>
+#include <filesystem>
 #include <fstream>
+#include <optional>
+#include <vector>
 
 void printUsage() {
     std::cout << "JSON Parser & Generator\n";
@@ -13,15 +22,33 @@ void printUsage() {
     std::cout << "  minify <file>          Minify JSON file\n";
     std::cout << "  validate <file>        Validate JSON syntax\n";
     std::cout << "  query <file> <key>     Query JSON value by key\n";
+    std::cout << "  diff <a> <b>           Print a JSON Patch turning a into b\n";
+    std::cout << "  patch <file> <patch>   Apply a JSON Patch (or Merge Patch with --merge)\n";
+    std::cout << "  validate|minify|pretty <file|dir>...\n";
+    std::cout << "  query <file|dir>... <key>\n";
+    std::cout << "                         Batch mode over several files or directories\n";
+    std::cout << "\nOptions:\n";
+    std::cout << "  --stats                Print lexing/parsing/printing statistics to stderr\n";
+    std::cout << "  --max-depth <n>        Reject documents nested deeper than n (0 = unlimited)\n";
+    std::cout << "  --merge                Treat the patch file as an RFC 7396 Merge Patch\n";
+    std::cout << "  --jobs <n>             Batch mode: number of parser threads\n";
+    std::cout << "  --unordered            Batch mode: print results as they finish\n";
+    std::cout << "  --output-dir <dir>     Batch mode: write one output file per input\n";
+    std::cout << "  --schema <file>        validate: also check documents against a JSON Schema\n";
     std::cout << "\nExamples:\n";
     std::cout << "  json-parser parse data.json\n";
     std::cout << "  json-parser pretty data.json\n";
     std::cout << "  json-parser query data.json name\n";
+    std::cout << "  json-parser diff old.json new.json\n";
+    std::cout << "  json-parser patch data.json changes.json\n";
+    std::cout << "  json-parser validate data/ --jobs 8\n";
+    std::cout << "  json-parser validate data.json --stats\n";
+    std::cout << "  json-parser validate request.json --schema request.schema.json\n";
 }
 
-void handleParse(const std::string& filename) {
+void handleParse(const std::string& filename, const json::ParseOptions& options) {
     try {
-        json::JsonValue value = json::JsonParser::parseFile(filename);
+        json::JsonValue value = json::JsonParser::parseFile(filename, options);
         std::cout << "✓ JSON is valid!\n";
         std::cout << "\nParsed structure:\n";
         std::cout << json::JsonPrinter::print(value, false) << "\n";
@@ -30,36 +57,45 @@ void handleParse(const std::string& filename) {
     }
 }
 
-void handlePretty(const std::string& filename) {
+void handlePretty(const std::string& filename, const json::ParseOptions& options) {
     try {
-        json::JsonValue value = json::JsonParser::parseFile(filename);
+        json::JsonValue value = json::JsonParser::parseFile(filename, options);
         std::cout << json::JsonPrinter::print(value, true, 2) << "\n";
     } catch (const std::exception& e) {
         std::cerr << "✗ Error: " << e.what() << "\n";
     }
 }
 
-void handleMinify(const std::string& filename) {
+void handleMinify(const std::string& filename, const json::ParseOptions& options) {
     try {
-        json::JsonValue value = json::JsonParser::parseFile(filename);
+        json::JsonValue value = json::JsonParser::parseFile(filename, options);
         std::cout << json::JsonPrinter::print(value, false) << "\n";
     } catch (const std::exception& e) {
         std::cerr << "✗ Error: " << e.what() << "\n";
     }
 }
 
-void handleValidate(const std::string& filename) {
+void handleValidate(const std::string& filename, const json::ParseOptions& options, const json::JsonSchema* schema) {
     try {
-        json::JsonParser::parseFile(filename);
+        if (schema) {
+            // Checked while streaming the file; no document is built.
+            std::ifstream file(filename, std::ios::binary);
+            if (!file.is_open()) {
+                throw std::runtime_error("Could not open file: " + filename);
+            }
+            schema->validateStream(file, options);
+        } else {
+            json::JsonParser::parseFile(filename, options);
+        }
         std::cout << "✓ JSON is valid!\n";
     } catch (const std::exception& e) {
         std::cerr << "✗ Invalid JSON: " << e.what() << "\n";
     }
 }
 
-void handleQuery(const std::string& filename, const std::string& key) {
+void handleQuery(const std::string& filename, const std::string& key, const json::ParseOptions& options) {
     try {
-        json::JsonValue value = json::JsonParser::parseFile(filename);
+        json::JsonValue value = json::JsonParser::parseFile(filename, options);
         
         if (value.isObject() && value.hasKey(key)) {
             std::cout << "Value for key '" << key << "':\n";
@@ -72,28 +108,195 @@ void handleQuery(const std::string& filename, const std::string& key) {
     }
 }
 
+void handleDiff(const std::string& fromFile, const std::string& toFile, const json::ParseOptions& options) {
+    try {
+        json::JsonValue from = json::JsonParser::parseFile(fromFile, options);
+        json::JsonValue to = json::JsonParser::parseFile(toFile, options);
+        json::JsonValue patch = json::JsonDiff::diff(from, to);
+        std::cout << json::JsonPrinter::print(patch, true, 2) << "\n";
+    } catch (const std::exception& e) {
+        std::cerr << "✗ Error: " << e.what() << "\n";
+    }
+}
+
+void handlePatch(const std::string& filename, const std::string& patchFile, bool merge, const json::ParseOptions& options) {
+    try {
+        json::JsonValue value = json::JsonParser::parseFile(filename, options);
+        json::JsonValue patch = json::JsonParser::parseFile(patchFile, options);
+        if (merge) {
+            json::JsonPatch::applyMerge(value, patch);
+        } else {
+            json::JsonPatch::apply(value, patch);
+        }
+        std::cout << json::JsonPrinter::print(value, true, 2) << "\n";
+    } catch (const std::exception& e) {
+        std::cerr << "✗ Error: " << e.what() << "\n";
+    }
+}
+
+// Runs validate/minify/pretty/query over many files. Returns the exit status:
+// 0 when every file succeeded, 1 otherwise.
+int runBatch(const std::string& command, const std::vector<std::string>& paths, const std::string& key,
+             const std::string& outputDir, const json::BatchOptions& options) {
+    json::JsonBatch::Task task = [&](const json::JsonValue& value) -> std::string {
+        if (command == "pretty") {
+            return json::JsonPrinter::print(value, true, 2) + "\n";
+        } else if (command == "minify") {
+            return json::JsonPrinter::print(value, false) + "\n";
+        }
+        if (!value.isObject() || !value.hasKey(key)) {
+            throw std::runtime_error("Key '" + key + "' not found");
+        }
+        return json::JsonPrinter::print(value[key], true, 2) + "\n";
+    };
+    
+    auto onResult = [&](const json::BatchResult& result) {
+        if (!result.ok) {
+            std::cerr << "✗ " << result.input->path << ": " << result.error << "\n";
+        } else if (command == "validate") {
+            std::cout << "✓ " << result.input->path << "\n";
+        } else if (!outputDir.empty()) {
+            std::filesystem::path target = std::filesystem::path(outputDir) / result.input->name;
+            std::filesystem::create_directories(target.parent_path());
+            std::ofstream out(target, std::ios::binary);
+            out << result.output;
+            if (!out) {
+                throw std::runtime_error("Could not write file: " + target.string());
+            }
+        } else {
+            std::cout << "==> " << result.input->path << " <==\n" << result.output;
+        }
+    };
+    
+    std::vector<json::BatchInput> inputs = json::JsonBatch::collectInputs(paths);
+    if (!outputDir.empty() && command != "validate") {
+        // Outputs are written under the input names and must not collide.
+        json::JsonBatch::requireDistinctNames(inputs);
+    }
+    size_t failures = json::JsonBatch::run(inputs, task, onResult, options);
+    std::cerr << "Processed " << inputs.size() << " files: " << (inputs.size() - failures)
+              << " succeeded, " << failures << " failed\n";
+    return failures == 0 ? 0 : 1;
+}
+
+bool parseCount(const char* text, size_t& value) {
+    try {
+        value = std::stoul(text);
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+bool isBatchCommand(const std::string& command) {
+    return command == "validate" || command == "minify" || command == "pretty" || command == "query";
+}
+
 int main(int argc, char* argv[]) {
-    if (argc < 2) {
+    std::vector<std::string> args;
+    bool showStats = false;
+    bool mergePatch = false;
+    bool batchRequested = false;
+    std::string outputDir;
+    std::string schemaFile;
+    json::ParseOptions options;
+    json::BatchOptions batchOptions;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--stats") {
+            showStats = true;
+        } else if (arg == "--merge") {
+            mergePatch = true;
+        } else if (arg == "--max-depth" && i + 1 < argc) {
+            if (!parseCount(argv[++i], options.maxDepth)) {
+                std::cerr << "✗ Invalid --max-depth value: " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (arg == "--jobs" && i + 1 < argc) {
+            size_t jobs = 0;
+            if (!parseCount(argv[++i], jobs)) {
+                std::cerr << "✗ Invalid --jobs value: " << argv[i] << "\n";
+                return 1;
+            }
+            batchOptions.jobs = static_cast<unsigned>(jobs);
+            batchRequested = true;
+        } else if (arg == "--unordered") {
+            batchOptions.ordered = false;
+            batchRequested = true;
+        } else if (arg == "--output-dir" && i + 1 < argc) {
+            outputDir = argv[++i];
+            batchRequested = true;
+        } else if (arg == "--schema" && i + 1 < argc) {
+            schemaFile = argv[++i];
+        } else {
+            args.push_back(arg);
+        }
+    }
+    
+    if (args.empty()) {
         printUsage();
         return 1;
     }
     
-    std::string command = argv[1];
+    json::Stats::setEnabled(showStats);
+    
+    const std::string& command = args[0];
+    batchOptions.parse = options;
+    batchOptions.validateOnly = command == "validate";
+    
+    std::optional<json::JsonSchema> schema;
+    if (!schemaFile.empty()) {
+        if (command != "validate") {
+            std::cerr << "✗ --schema is only supported by validate\n";
+            return 1;
+        }
+        try {
+            schema.emplace(json::JsonSchema::fromFile(schemaFile, options));
+        } catch (const std::exception& e) {
+            std::cerr << "✗ Schema error: " << e.what() << "\n";
+            return 1;
+        }
+        batchOptions.schema = &*schema;
+    }
     
-    if (command == "parse" && argc >= 3) {
-        handleParse(argv[2]);
-    } else if (command == "pretty" && argc >= 3) {
-        handlePretty(argv[2]);
-    } else if (command == "minify" && argc >= 3) {
-        handleMinify(argv[2]);
-    } else if (command == "validate" && argc >= 3) {
-        handleValidate(argv[2]);
-    } else if (command == "query" && argc >= 4) {
-        handleQuery(argv[2], argv[3]);
+    // Batch mode: several inputs, a directory, or any batch-only option.
+    size_t pathCount = command == "query" ? std::max<size_t>(args.size(), 2) - 2 : args.size() - 1;
+    bool batch = batchRequested || pathCount > 1;
+    for (size_t i = 1; !batch && i <= pathCount; ++i) {
+        batch = std::filesystem::is_directory(args[i]);
+    }
+    
+    int status = 0;
+    if (isBatchCommand(command) && batch && pathCount > 0) {
+        std::vector<std::string> paths(args.begin() + 1, args.begin() + 1 + static_cast<std::ptrdiff_t>(pathCount));
+        try {
+            status = runBatch(command, paths, command == "query" ? args.back() : "", outputDir, batchOptions);
+        } catch (const std::exception& e) {
+            std::cerr << "✗ Error: " << e.what() << "\n";
+            status = 1;
+        }
+    } else if (command == "parse" && args.size() >= 2) {
+        handleParse(args[1], options);
+    } else if (command == "pretty" && args.size() >= 2) {
+        handlePretty(args[1], options);
+    } else if (command == "minify" && args.size() >= 2) {
+        handleMinify(args[1], options);
+    } else if (command == "validate" && args.size() >= 2) {
+        handleValidate(args[1], options, schema ? &*schema : nullptr);
+    } else if (command == "query" && args.size() >= 3) {
+        handleQuery(args[1], args[2], options);
+    } else if (command == "diff" && args.size() >= 3) {
+        handleDiff(args[1], args[2], options);
+    } else if (command == "patch" && args.size() >= 3) {
+        handlePatch(args[1], args[2], mergePatch, options);
     } else {
         printUsage();
         return 1;
     }
     
-    return 0;
+    if (showStats) {
+        json::Stats::report(std::cerr);
+    }
+    
+    return status;
 }
\ No newline at end of file
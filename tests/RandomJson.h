@@ -0,0 +1,79 @@
+#ifndef JSON_TEST_RANDOM_JSON_H
+#define JSON_TEST_RANDOM_JSON_H
+
+#include "JsonValue.h"
+#include <random>
+#include <string>
+
+// Small random documents for round-trip tests. Keys include the characters
+// JSON Pointer has to escape, and array edits shift elements so that diffs
+// need the LCS alignment.
+namespace json_test {
+
+class RandomJson {
+public:
+    explicit RandomJson(unsigned seed) : rng_(seed) {}
+
+    json::JsonValue document(int depth = 0) {
+        int kind = depth >= 4 ? pick(4) : pick(7);
+        switch (kind) {
+            case 0: return json::JsonValue();
+            case 1: return json::JsonValue(chance(50));
+            case 2: return json::JsonValue(static_cast<double>(pick(5)));
+            case 3: return json::JsonValue(key());
+            case 4:
+            case 5: {
+                json::JsonValue array = json::JsonValue::makeArray();
+                for (int i = pick(7); i > 0; --i) array.push_back(document(depth + 1));
+                return array;
+            }
+            default: {
+                json::JsonValue object = json::JsonValue::makeObject();
+                for (int i = pick(6); i > 0; --i) object.set(key(), document(depth + 1));
+                return object;
+            }
+        }
+    }
+
+    // Returns a copy of `value` with random insertions, removals and changes.
+    json::JsonValue mutate(const json::JsonValue& value, int depth = 0) {
+        if (chance(10)) {
+            return document(depth);
+        }
+        if (value.isArray()) {
+            json::JsonValue array = json::JsonValue::makeArray();
+            for (const auto& element : value.getArray()) {
+                if (chance(15)) array.push_back(document(depth + 1));
+                if (chance(15)) continue;
+                array.push_back(chance(30) ? mutate(element, depth + 1) : element);
+            }
+            if (chance(20)) array.push_back(document(depth + 1));
+            return array;
+        }
+        if (value.isObject()) {
+            json::JsonValue object = json::JsonValue::makeObject();
+            for (const auto& member : value.getObject()) {
+                if (chance(15)) continue;
+                object.set(member.first, chance(30) ? mutate(member.second, depth + 1) : json::JsonValue(member.second));
+            }
+            if (chance(30)) object.set(key(), document(depth + 1));
+            return object;
+        }
+        return chance(30) ? document(depth) : value;
+    }
+
+private:
+    int pick(int count) { return std::uniform_int_distribution<int>(0, count - 1)(rng_); }
+    bool chance(int percent) { return pick(100) < percent; }
+
+    std::string key() {
+        static const char* const kKeys[] = {"a", "b", "c", "a/b", "m~n", "", "~1"};
+        return kKeys[pick(7)];
+    }
+
+    std::mt19937 rng_;
+};
+
+} // namespace json_test
+
+#endif // JSON_TEST_RANDOM_JSON_H
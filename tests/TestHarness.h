@@ -0,0 +1,72 @@
+#ifndef JSON_TEST_HARNESS_H
+#define JSON_TEST_HARNESS_H
+
+#include "JsonParser.h"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Minimal self-registering test cases. Every tests/*.cpp is linked into the
+// single json-tests executable, whose main() lives in test_main.cpp.
+namespace json_test {
+
+struct TestCase {
+    const char* name;
+    void (*run)();
+};
+
+inline std::vector<TestCase>& registry() {
+    static std::vector<TestCase> tests;
+    return tests;
+}
+
+struct Registration {
+    Registration(const char* name, void (*run)()) { registry().push_back(TestCase{name, run}); }
+};
+
+class Failure : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+inline std::string location(const char* file, int line) {
+    return std::string(file) + ":" + std::to_string(line) + ": ";
+}
+
+// Parses a document written inline in a test.
+inline json::JsonValue parse(const std::string& text) {
+    return json::JsonParser(text).parse();
+}
+
+} // namespace json_test
+
+#define TEST(name)                                                              \
+    static void name();                                                         \
+    static const json_test::Registration name##Registration(#name, name);       \
+    static void name()
+
+#define CHECK(condition)                                                        \
+    do {                                                                        \
+        if (!(condition)) {                                                     \
+            throw json_test::Failure(json_test::location(__FILE__, __LINE__) +  \
+                                     "CHECK(" #condition ") failed");           \
+        }                                                                       \
+    } while (0)
+
+#define CHECK_THROWS(expression)                                                \
+    do {                                                                        \
+        bool thrown = false;                                                    \
+        try {                                                                   \
+            (void)(expression);                                                 \
+        } catch (const json_test::Failure&) {                                   \
+            throw;                                                              \
+        } catch (const std::exception&) {                                       \
+            thrown = true;                                                      \
+        }                                                                       \
+        if (!thrown) {                                                          \
+            throw json_test::Failure(json_test::location(__FILE__, __LINE__) +  \
+                                     #expression " did not throw");             \
+        }                                                                       \
+    } while (0)
+
+#endif // JSON_TEST_HARNESS_H
@@ -0,0 +1,61 @@
+#include "JsonCursor.h"
+#include "TestHarness.h"
+#include <sstream>
+
+#ifndef JSON_HAS_COROUTINES
+#error "json-tests-cxx20 must be built as C++20 with coroutine support"
+#endif
+
+using json::JsonCursor;
+using json::JsonValue;
+using json_test::parse;
+
+// Built only as C++20 (see CMakeLists.txt), where JsonCursor.h adds elements().
+
+TEST(generatorYieldsEveryElement) {
+    const char* text = R"([1, {"a": [2, 3]}, "x", [], null])";
+    const JsonValue tree = parse(text);
+    std::istringstream input(text);
+    JsonCursor cursor(input);
+
+    size_t count = 0;
+    for (JsonValue& element : json::elements(cursor)) {
+        CHECK(element == tree[count]);
+        count++;
+    }
+    CHECK(count == tree.size());
+}
+
+TEST(generatorResumesAfterManualSteps) {
+    std::istringstream input("[1, 2, 3, 4]");
+    JsonCursor cursor(input);
+    CHECK(cursor.next());
+    cursor.skip();
+
+    double sum = 0;
+    for (JsonValue& element : json::elements(cursor)) {
+        sum += element.asNumber();
+        if (cursor.index() == 2) break;   // destroys the suspended coroutine
+    }
+    CHECK(sum == 5);
+    CHECK(cursor.next());
+    CHECK(cursor.readValue() == JsonValue(4.0));
+}
+
+TEST(generatorRethrowsParseErrors) {
+    std::istringstream input("[1, {\"a\": }, 3]");
+    JsonCursor cursor(input);
+    auto drain = [&cursor]() {
+        for (JsonValue& element : json::elements(cursor)) (void)element;
+    };
+    CHECK_THROWS(drain());
+}
+
+TEST(generatorRejectsTrailingData) {
+    std::istringstream input("[1, 2] [3]");
+    JsonCursor cursor(input);
+    auto drain = [&cursor]() {
+        for (JsonValue& element : json::elements(cursor)) (void)element;
+    };
+    CHECK_THROWS(drain());
+}
@@ -0,0 +1,160 @@
+#include "JsonBatch.h"
+#include "JsonPrinter.h"
+#include "JsonSchema.h"
+#include "TestHarness.h"
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using json::BatchInput;
+using json::BatchOptions;
+using json::BatchResult;
+using json::JsonBatch;
+using json::JsonValue;
+using json_test::parse;
+
+namespace {
+
+namespace fs = std::filesystem;
+
+// A scratch directory that is removed with everything in it.
+class TempDir {
+public:
+    TempDir() : path_(fs::temp_directory_path() / ("json-tests-" + std::to_string(std::random_device{}()))) {
+        fs::create_directories(path_);
+    }
+    ~TempDir() {
+        std::error_code ec;
+        fs::remove_all(path_, ec);
+    }
+
+    std::string write(const std::string& name, const std::string& content) const {
+        fs::path file = path_ / name;
+        fs::create_directories(file.parent_path());
+        std::ofstream(file, std::ios::binary) << content;
+        return file.string();
+    }
+
+    std::string path() const { return path_.string(); }
+
+private:
+    fs::path path_;
+};
+
+std::string minify(const JsonValue& value) {
+    return json::JsonPrinter::print(value);
+}
+
+} // namespace
+
+TEST(batchDeliversResultsInInputOrder) {
+    TempDir dir;
+    std::vector<std::string> expected;
+    for (int i = 0; i < 40; ++i) {
+        // Sizes vary so that files finish out of order across workers.
+        JsonValue document = JsonValue::makeArray();
+        for (int j = 0; j < (i % 7) * 500; ++j) document.push_back(JsonValue(static_cast<double>(j)));
+        document.push_back(JsonValue(static_cast<double>(i)));
+        dir.write("f" + std::to_string(i) + ".json", minify(document));
+        expected.push_back(minify(document));
+    }
+    std::vector<BatchInput> inputs;
+    for (int i = 0; i < 40; ++i) {
+        inputs.push_back(BatchInput{dir.path() + "/f" + std::to_string(i) + ".json", "f" + std::to_string(i)});
+    }
+
+    for (unsigned jobs : {1u, 4u}) {
+        BatchOptions options;
+        options.jobs = jobs;
+        options.readAhead = 1;
+        std::vector<std::string> outputs;
+        const std::thread::id caller = std::this_thread::get_id();
+        size_t failures = JsonBatch::run(inputs, minify, [&](const BatchResult& result) {
+            CHECK(std::this_thread::get_id() == caller);
+            CHECK(result.ok);
+            CHECK(result.index == outputs.size());
+            CHECK(result.input == &inputs[result.index]);
+            outputs.push_back(result.output);
+        }, options);
+        CHECK(failures == 0);
+        CHECK(outputs == expected);
+    }
+}
+
+TEST(batchReportsEachFailedFile) {
+    TempDir dir;
+    std::vector<BatchInput> inputs = {
+        {dir.write("good.json", R"({"k": 1})"), "good.json"},
+        {dir.write("bad.json", R"({"k": })"), "bad.json"},
+        {dir.path() + "/missing.json", "missing.json"},
+        {dir.write("nokey.json", "[]"), "nokey.json"},
+        {dir.write("also-good.json", R"({"k": [2]})"), "also-good.json"},
+    };
+    JsonBatch::Task task = [](const JsonValue& value) {
+        if (!value.isObject() || !value.hasKey("k")) throw std::runtime_error("Key 'k' not found");
+        return minify(value["k"]);
+    };
+
+    for (bool ordered : {true, false}) {
+        BatchOptions options;
+        options.jobs = 3;
+        options.ordered = ordered;
+        std::vector<BatchResult> results(inputs.size());
+        std::vector<int> delivered(inputs.size(), 0);
+        size_t failures = JsonBatch::run(inputs, task, [&](const BatchResult& result) {
+            delivered[result.index]++;
+            results[result.index] = result;
+        }, options);
+
+        CHECK(failures == 3);
+        CHECK(delivered == std::vector<int>(inputs.size(), 1));
+        CHECK(results[0].ok && results[0].output == "1");
+        CHECK(!results[1].ok && !results[1].error.empty());
+        CHECK(!results[2].ok && results[2].error.find("Could not open file") == 0);
+        CHECK(!results[3].ok && results[3].error == "Key 'k' not found");
+        CHECK(results[4].ok && results[4].output == "[2]");
+    }
+}
+
+TEST(batchValidatesAgainstSchema) {
+    TempDir dir;
+    json::JsonSchema schema(parse(R"({"type": "object", "required": ["id"]})"));
+    std::vector<BatchInput> inputs = {
+        {dir.write("a.json", R"({"id": 1})"), "a.json"},
+        {dir.write("b.json", R"({"name": "x"})"), "b.json"},
+        {dir.write("c.json", R"({"id": 2} [])"), "c.json"},
+    };
+    BatchOptions options;
+    options.jobs = 2;
+    options.schema = &schema;
+    options.validateOnly = true;
+
+    std::vector<std::string> errors(inputs.size());
+    size_t failures = JsonBatch::run(inputs, minify, [&](const BatchResult& result) {
+        CHECK(result.output.empty());
+        errors[result.index] = result.error;
+    }, options);
+    CHECK(failures == 2);
+    CHECK(errors[0].empty());
+    CHECK(errors[1].find("Schema violation at document root") == 0);
+    CHECK(errors[2].find("Unexpected data after JSON value") == 0);
+}
+
+TEST(batchRefusesCollidingOutputNames) {
+    TempDir dir;
+    dir.write("a.json", "1");
+    dir.write("nested/b.json", "2");
+    std::string other = dir.write("other/a.json", "3");
+
+    std::vector<BatchInput> inputs = JsonBatch::collectInputs({dir.path() + "/nested", other});
+    CHECK(inputs.size() == 2);
+    CHECK(inputs[0].name == "b.json" && inputs[1].name == "a.json");
+    JsonBatch::requireDistinctNames(inputs);
+
+    inputs = JsonBatch::collectInputs({dir.path() + "/a.json", other});
+    CHECK(inputs.size() == 2);
+    CHECK_THROWS(JsonBatch::requireDistinctNames(inputs));
+}
@@ -0,0 +1,110 @@
+#include "JsonCursor.h"
+#include "JsonParser.h"
+#include "JsonPrinter.h"
+#include "RandomJson.h"
+#include "TestHarness.h"
+#include <sstream>
+#include <string>
+
+using json::JsonCursor;
+using json::JsonValue;
+using json::ParseOptions;
+using json_test::parse;
+
+namespace {
+
+const char* const kRecords = R"([1, {"a": [2, 3], "b": null}, "x", [], {}, [[true]], -0.5e3])";
+
+void drain(JsonCursor& cursor) {
+    while (cursor.next()) cursor.skip();
+}
+
+} // namespace
+
+TEST(cursorReadsEveryElement) {
+    const JsonValue tree = parse(kRecords);
+    std::istringstream input(kRecords);
+    JsonCursor cursor(input);
+
+    size_t count = 0;
+    while (cursor.next()) {
+        CHECK(cursor.index() == count);
+        CHECK(cursor.readValue() == tree[count]);
+        count++;
+    }
+    CHECK(count == tree.size());
+    CHECK(!cursor.next());
+}
+
+TEST(cursorSkipsElementsItDoesNotRead) {
+    const JsonValue tree = parse(kRecords);
+    std::istringstream input(kRecords);
+    JsonCursor cursor(input);
+
+    // Explicit skip() on even elements, implicit skip by next() on some odd ones.
+    while (cursor.next()) {
+        size_t index = cursor.index();
+        if (index % 2 == 0) {
+            cursor.skip();
+        } else if (index != 3) {
+            CHECK(cursor.readValue() == tree[index]);
+        }
+    }
+    CHECK(cursor.index() == tree.size() - 1);
+}
+
+TEST(cursorIteratorMatchesTreeParse) {
+    json_test::RandomJson random(32);
+    for (int i = 0; i < 50; ++i) {
+        JsonValue array = JsonValue::makeArray();
+        for (int j = i % 7; j > 0; --j) array.push_back(random.document());
+        std::string text = json::JsonPrinter::print(array, i % 2 == 0);
+
+        std::istringstream input(text);
+        JsonCursor cursor(input);
+        JsonValue streamed = JsonValue::makeArray();
+        for (JsonValue& element : cursor) streamed.push_back(element);
+        CHECK(streamed == parse(text));
+    }
+}
+
+TEST(cursorRequiresCallsInOrder) {
+    std::istringstream input("[1, 2]");
+    JsonCursor cursor(input);
+    CHECK_THROWS(cursor.readValue());
+    CHECK(cursor.next());
+    CHECK(cursor.readValue() == JsonValue(1.0));
+    CHECK_THROWS(cursor.readValue());
+    CHECK_THROWS(cursor.skip());
+}
+
+TEST(cursorRejectsMalformedArrays) {
+    for (const char* text : {"{}", "1", "[1 2]", "[1,]", "[1, 2", "", "[1,2] garbage", "[] []", "[1] 2"}) {
+        std::istringstream input(text);
+        JsonCursor cursor(input);
+        CHECK_THROWS(drain(cursor));
+    }
+}
+
+TEST(cursorEnforcesTheParserDepthLimit) {
+    ParseOptions options;
+    options.maxDepth = 3;
+
+    // The array itself is depth 1, exactly as for JsonParser.
+    std::istringstream fits("[[[1]], 2]");
+    JsonCursor within(fits, options);
+    CHECK(within.next());
+    CHECK(within.readValue() == parse("[[1]]"));
+    CHECK(json::JsonParser("[[[1]], 2]", options).parse().size() == 2);
+
+    std::istringstream tooDeep("[[[[1]]]]");
+    JsonCursor reading(tooDeep, options);
+    CHECK(reading.next());
+    CHECK_THROWS(reading.readValue());
+    CHECK_THROWS(json::JsonParser("[[[[1]]]]", options).parse());
+
+    std::istringstream skipped("[[[[1]]]]");
+    JsonCursor skipping(skipped, options);
+    CHECK(skipping.next());
+    CHECK_THROWS(skipping.skip());
+}
@@ -0,0 +1,95 @@
+#include "JsonDiff.h"
+#include "JsonPatch.h"
+#include "JsonParser.h"
+#include "JsonPrinter.h"
+#include "RandomJson.h"
+#include "TestHarness.h"
+
+using json::DiffOptions;
+using json::JsonDiff;
+using json::JsonPatch;
+using json::JsonValue;
+
+namespace {
+
+void checkRoundTrips(const DiffOptions& options, unsigned seed) {
+    json_test::RandomJson random(seed);
+    for (int i = 0; i < 300; ++i) {
+        JsonValue from = random.document();
+        JsonValue to = random.mutate(from);
+
+        JsonValue patched = from;
+        JsonPatch::apply(patched, JsonDiff::diff(from, to, options));
+        CHECK(patched == to);
+    }
+}
+
+} // namespace
+
+TEST(diffRoundTripsThroughPatch) {
+    DiffOptions options;
+    options.threads = 1;
+    checkRoundTrips(options, 1);
+}
+
+TEST(diffRoundTripsWithPositionalArrays) {
+    DiffOptions options;
+    options.threads = 1;
+    options.maxLcsCells = 1;
+    checkRoundTrips(options, 2);
+}
+
+TEST(diffRoundTripsAcrossThreads) {
+    DiffOptions options;
+    options.threads = 4;
+    options.parallelThreshold = 2;
+    checkRoundTrips(options, 3);
+}
+
+TEST(diffAlignsShiftedArrayElements) {
+    JsonValue from = json::JsonParser(R"([{"id": 1}, {"id": 2}, {"id": 3}, {"id": 4}])").parse();
+    JsonValue to = json::JsonParser(R"([{"id": 0}, {"id": 1}, {"id": 2}, {"id": 3}, {"id": 4}])").parse();
+
+    JsonValue patch = JsonDiff::diff(from, to);
+    CHECK(patch.size() == 1);
+    CHECK(patch[0]["op"].asString() == "add");
+    CHECK(patch[0]["path"].asString() == "/0");
+}
+
+TEST(diffOfEqualDocumentsIsEmpty) {
+    json_test::RandomJson random(4);
+    for (int i = 0; i < 50; ++i) {
+        JsonValue document = random.document();
+        JsonValue reparsed = json::JsonParser(json::JsonPrinter::print(document)).parse();
+        CHECK(JsonDiff::diff(document, JsonValue(document)).size() == 0);
+        CHECK(JsonDiff::diff(document, reparsed).size() == 0);
+    }
+}
+
+TEST(diffEscapesPointerTokens) {
+    JsonValue from = json::JsonParser(R"({"a/b": {"m~n": 1}})").parse();
+    JsonValue to = json::JsonParser(R"({"a/b": {"m~n": 2}})").parse();
+
+    JsonValue patch = JsonDiff::diff(from, to);
+    CHECK(patch.size() == 1);
+    CHECK(patch[0]["path"].asString() == "/a~1b/m~0n");
+}
+
+TEST(diffHandlesDeepNesting) {
+    const size_t depth = 50000;
+    JsonValue from(1.0);
+    JsonValue to(2.0);
+    for (size_t i = 0; i < depth; ++i) {
+        JsonValue outerFrom = JsonValue::makeArray();
+        outerFrom.push_back(std::move(from));
+        from = std::move(outerFrom);
+        JsonValue outerTo = JsonValue::makeArray();
+        outerTo.push_back(std::move(to));
+        to = std::move(outerTo);
+    }
+
+    JsonValue patch = JsonDiff::diff(from, to);
+    CHECK(patch.size() == 1);
+    CHECK(patch[0]["op"].asString() == "replace");
+    CHECK(patch[0]["path"].asString().size() == 2 * depth);
+}
@@ -0,0 +1,19 @@
+#include "TestHarness.h"
+#include <exception>
+#include <iostream>
+
+int main() {
+    size_t failures = 0;
+    for (const auto& test : json_test::registry()) {
+        try {
+            test.run();
+            std::cout << "[ OK ] " << test.name << "\n";
+        } catch (const std::exception& e) {
+            std::cout << "[FAIL] " << test.name << ": " << e.what() << "\n";
+            failures++;
+        }
+    }
+    std::cout << json_test::registry().size() - failures << "/" << json_test::registry().size()
+              << " tests passed\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,94 @@
+#include "JsonParser.h"
+#include "JsonPrinter.h"
+#include "TestHarness.h"
+#include <sstream>
+#include <string>
+
+using json::JsonParser;
+using json::JsonValue;
+using json::ParseOptions;
+
+namespace {
+
+// `depth` nested arrays, or objects under the key "k", around a null.
+std::string nested(size_t depth, bool objects) {
+    std::string text;
+    text.reserve(depth * 6 + 4);
+    for (size_t i = 0; i < depth; ++i) text += objects ? "{\"k\":" : "[";
+    text += "null";
+    for (size_t i = 0; i < depth; ++i) text += objects ? "}" : "]";
+    return text;
+}
+
+JsonValue parseStreamed(const std::string& text, const ParseOptions& options) {
+    std::istringstream input(text);
+    return JsonParser(input, options).parse();
+}
+
+// The error thrown by parsing `text`, or an empty string.
+std::string depthError(const std::string& text, const ParseOptions& options, bool streamed) {
+    try {
+        if (streamed) {
+            parseStreamed(text, options);
+        } else {
+            JsonParser(text, options).parse();
+        }
+        return "";
+    } catch (const std::runtime_error& e) {
+        return e.what();
+    }
+}
+
+} // namespace
+
+TEST(parserAcceptsExactlyMaxDepth) {
+    ParseOptions options;
+    options.maxDepth = 64;
+    for (bool objects : {false, true}) {
+        for (bool streamed : {false, true}) {
+            CHECK(depthError(nested(64, objects), options, streamed).empty());
+
+            std::string error = depthError(nested(65, objects), options, streamed);
+            CHECK(error.find("Maximum nesting depth of 64 exceeded") == 0);
+        }
+    }
+}
+
+TEST(parserDepthLimitCanBeDisabled) {
+    ParseOptions options;
+    options.maxDepth = 0;
+    CHECK(!JsonParser(nested(ParseOptions().maxDepth + 1, false), options).parse().isNull());
+    CHECK_THROWS(JsonParser(nested(ParseOptions().maxDepth + 1, false)).parse());
+}
+
+TEST(parserHandlesVeryDeepDocumentsIteratively) {
+    const size_t depth = 100000;
+    ParseOptions options;
+    options.maxDepth = depth;
+
+    for (bool objects : {false, true}) {
+        std::string text = nested(depth, objects);
+        JsonValue document = JsonParser(text, options).parse();
+        CHECK(json::JsonPrinter::print(document) == text);
+
+        const JsonValue* inner = &document;
+        size_t levels = 0;
+        while (!inner->isNull()) {
+            inner = objects ? &inner->getObject().at("k") : &inner->getArray().front();
+            levels++;
+        }
+        CHECK(levels == depth);
+
+        CHECK(parseStreamed(text, options) == document);
+        CHECK_THROWS(parseStreamed(nested(depth + 1, objects), options));
+        // Both trees are destroyed here without recursing.
+    }
+}
+
+TEST(parserRejectsTrailingData) {
+    for (const char* text : {"1 2", "{} {}", "[] x", "null,", "\"a\" \"b\""}) {
+        CHECK_THROWS(JsonParser(text).parse());
+        CHECK_THROWS(parseStreamed(text, ParseOptions()));
+    }
+    CHECK(JsonParser(" [1]\n\t ").parse().size() == 1);
+}
@@ -0,0 +1,69 @@
+#include "JsonDiff.h"
+#include "JsonPatch.h"
+#include "RandomJson.h"
+#include "TestHarness.h"
+
+using json::JsonDiff;
+using json::JsonPatch;
+using json::JsonValue;
+using json_test::parse;
+
+namespace {
+
+// Applies `patch`, which must fail, and checks that `document` is untouched.
+void checkRollback(const std::string& document, const std::string& patch) {
+    JsonValue value = parse(document);
+    const JsonValue original = parse(document);
+    CHECK_THROWS(JsonPatch::apply(value, parse(patch)));
+    CHECK(value == original);
+}
+
+} // namespace
+
+TEST(patchAppliesEveryOperation) {
+    JsonValue document = parse(R"({"a": [1, 2], "b": {"c": 3}})");
+    JsonPatch::apply(document, parse(R"([
+        {"op": "add", "path": "/a/-", "value": 4},
+        {"op": "remove", "path": "/a/0"},
+        {"op": "replace", "path": "/b/c", "value": "x"},
+        {"op": "move", "from": "/b/c", "path": "/d"},
+        {"op": "copy", "from": "/a", "path": "/b/e"},
+        {"op": "test", "path": "/b/e/1", "value": 4}
+    ])"));
+    CHECK(document == parse(R"({"a": [2, 4], "b": {"e": [2, 4]}, "d": "x"})"));
+}
+
+TEST(patchRollsBackEachOperationKind) {
+    const std::string document = R"({"a": [1, 2, 3], "b": {"c": {"d": true}}, "e": "f"})";
+    checkRollback(document, R"([{"op": "add", "path": "/a/1", "value": 9}, {"op": "remove", "path": "/x"}])");
+    checkRollback(document, R"([{"op": "remove", "path": "/a/0"}, {"op": "remove", "path": "/b/c/d"},
+                                {"op": "test", "path": "/e", "value": "g"}])");
+    checkRollback(document, R"([{"op": "replace", "path": "", "value": 1}, {"op": "add", "path": "/q/r", "value": 1}])");
+    checkRollback(document, R"([{"op": "move", "from": "/b/c", "path": "/a/0"}, {"op": "move", "from": "/e", "path": "/a/9"}])");
+    checkRollback(document, R"([{"op": "copy", "from": "/b", "path": "/b/c/z"}, {"op": "replace", "path": "/a/7", "value": 0}])");
+    checkRollback(document, R"([{"op": "add", "path": "/a/-", "value": [1]}, {"op": "bogus", "path": "/a"}])");
+}
+
+TEST(patchRollsBackRandomDiffs) {
+    json_test::RandomJson random(5);
+    json::DiffOptions options;
+    options.threads = 1;
+    for (int i = 0; i < 300; ++i) {
+        JsonValue from = random.document();
+        JsonValue to = random.mutate(from);
+
+        // A valid patch followed by an operation that always fails.
+        JsonValue patch = JsonDiff::diff(from, to, options);
+        patch.push_back(parse(R"({"op": "test", "path": "", "value": "never equal"})"));
+
+        JsonValue document = from;
+        CHECK_THROWS(JsonPatch::apply(document, patch));
+        CHECK(document == from);
+    }
+}
+
+TEST(mergePatchFollowsRfc7396) {
+    JsonValue document = parse(R"({"a": "b", "c": {"d": "e", "f": "g"}})");
+    JsonPatch::applyMerge(document, parse(R"({"a": "z", "c": {"f": null}, "h": [1]})"));
+    CHECK(document == parse(R"({"a": "z", "c": {"d": "e"}, "h": [1]})"));
+}
@@ -0,0 +1,214 @@
+#include "JsonPattern.h"
+#include "JsonPrinter.h"
+#include "JsonSchema.h"
+#include "RandomJson.h"
+#include "TestHarness.h"
+#include <sstream>
+
+using json::JsonSchema;
+using json::JsonValue;
+using json_test::parse;
+
+namespace {
+
+const JsonSchema& orderSchema() {
+    static const JsonSchema schema(parse(R"({
+        "type": "object",
+        "required": ["id", "items"],
+        "properties": {
+            "id": {"type": "integer", "minimum": 1},
+            "items": {
+                "type": "array",
+                "maxItems": 3,
+                "items": {
+                    "type": "object",
+                    "properties": {
+                        "name": {"type": "string", "pattern": "^[a-z]+$", "maxLength": 1e30},
+                        "tags": {"type": "array", "items": {"enum": ["x", "y"]}}
+                    },
+                    "additionalProperties": false
+                }
+            },
+            "a/b": {"const": {"k": [1, 2]}}
+        }
+    })"));
+    return schema;
+}
+
+// Runs every validation entry point and checks they agree. Returns the
+// error message, or an empty string when the document is valid.
+std::string validateAll(const JsonSchema& schema, const std::string& text) {
+    auto capture = [](auto&& check) -> std::string {
+        try {
+            check();
+            return "";
+        } catch (const json_test::Failure&) {
+            throw;
+        } catch (const std::runtime_error& e) {
+            return e.what();
+        }
+    };
+
+    JsonValue document = parse(text);
+    std::string tree = capture([&]() { schema.validate(document); });
+    std::string parsed = capture([&]() { CHECK(schema.parse(text) == document); });
+    std::string streamed = capture([&]() { schema.validateStream(text); });
+    std::string fromStream = capture([&]() {
+        std::istringstream input(text);
+        schema.validateStream(input);
+    });
+
+    CHECK(schema.isValid(document) == tree.empty());
+    CHECK(parsed == tree);
+    CHECK(streamed == tree);
+    CHECK(fromStream == tree);
+    return tree;
+}
+
+// Every entry point rejects `text` as malformed JSON.
+bool rejectedEverywhere(const JsonSchema& schema, const std::string& text) {
+    auto throws = [](auto&& check) {
+        try {
+            check();
+            return false;
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+    };
+    std::istringstream input(text);
+    return throws([&]() { parse(text); }) && throws([&]() { schema.parse(text); }) &&
+           throws([&]() { schema.validateStream(text); }) && throws([&]() { schema.validateStream(input); });
+}
+
+bool reportsAt(const std::string& message, const std::string& location) {
+    std::string prefix = "Schema violation at " + location + ":";
+    return message.compare(0, prefix.size(), prefix) == 0;
+}
+
+} // namespace
+
+TEST(schemaAcceptsValidDocuments) {
+    CHECK(validateAll(orderSchema(), R"({"id": 1, "items": []})").empty());
+    CHECK(validateAll(orderSchema(), R"({"id": 2, "items": [{"name": "ab", "tags": ["x", "y"]}],
+                                         "a/b": {"k": [1, 2]}, "other": null})").empty());
+}
+
+TEST(schemaTreeAndStreamReportTheSamePointer) {
+    const JsonSchema& schema = orderSchema();
+    CHECK(reportsAt(validateAll(schema, R"({"id": 0, "items": []})"), "/id"));
+    CHECK(reportsAt(validateAll(schema, R"({"id": 1.5, "items": []})"), "/id"));
+    CHECK(reportsAt(validateAll(schema, R"({"items": []})"), "document root"));
+    CHECK(reportsAt(validateAll(schema, R"([1])"), "document root"));
+    CHECK(reportsAt(validateAll(schema, R"({"id": 1, "items": [{"name": "ok"}, {"name": "Bad"}]})"), "/items/1/name"));
+    CHECK(reportsAt(validateAll(schema, R"({"id": 1, "items": [{"tags": ["x", "z"]}]})"), "/items/0/tags/1"));
+    CHECK(reportsAt(validateAll(schema, R"({"id": 1, "items": [{"extra": 1}]})"), "/items/0/extra"));
+    CHECK(reportsAt(validateAll(schema, R"({"id": 1, "items": [{}, {}, {}, {}]})"), "/items"));
+    CHECK(reportsAt(validateAll(schema, R"({"id": 1, "items": [], "a/b": {"k": [1, 3]}})"), "/a~1b"));
+}
+
+TEST(schemaTreeAndStreamAgreeOnRandomDocuments) {
+    json_test::RandomJson random(6);
+    const JsonValue base = parse(R"({"id": 1, "items": [{"name": "ab", "tags": ["x"]}, {}]})");
+    size_t valid = 0;
+    for (int i = 0; i < 500; ++i) {
+        JsonValue document = random.mutate(base);
+        std::string text = json::JsonPrinter::print(document);
+        bool treeValid = orderSchema().isValid(document);
+        bool streamValid = true;
+        try {
+            orderSchema().validateStream(text);
+        } catch (const std::runtime_error&) {
+            streamValid = false;
+        }
+        CHECK(treeValid == streamValid);
+        valid += treeValid ? 1 : 0;
+    }
+    CHECK(valid > 0);
+}
+
+TEST(schemaStreamsTopLevelArraysLikeTheTree) {
+    JsonSchema schema(parse(R"({"type": "array", "minItems": 2, "maxItems": 3,
+                                "items": {"type": "object", "required": ["n"],
+                                          "properties": {"n": {"type": "integer"}}}})"));
+    CHECK(validateAll(schema, R"([{"n": 1}, {"n": 2}])").empty());
+    CHECK(reportsAt(validateAll(schema, R"([{"n": 1}, {"n": "x"}])"), "/1/n"));
+    CHECK(reportsAt(validateAll(schema, R"([{"n": 1}, {}, {"n": 2.5}])"), "/1"));
+    CHECK(reportsAt(validateAll(schema, R"({"n": 1})"), "document root"));
+    // The size is checked before the elements, as by the tree validator.
+    CHECK(reportsAt(validateAll(schema, R"([{}])"), "document root"));
+    CHECK(reportsAt(validateAll(schema, R"([{}, {"n": 1}, {"n": 2}, {"n": 3}])"), "document root"));
+
+    JsonSchema constant(parse(R"({"const": [1, 2]})"));
+    CHECK(validateAll(constant, "[1, 2]").empty());
+    CHECK(reportsAt(validateAll(constant, "[1, 3]"), "document root"));
+
+    JsonSchema containers(parse(R"({"items": {"type": ["object", "array"], "maxProperties": 2,
+                                              "properties": {"a": {"type": "null"}}}})"));
+    json_test::RandomJson random(34);
+    size_t valid = 0;
+    for (int i = 0; i < 300; ++i) {
+        JsonValue records = JsonValue::makeArray();
+        for (int j = i % 5; j > 0; --j) records.push_back(random.document());
+        valid += validateAll(containers, json::JsonPrinter::print(random.mutate(records))).empty() ? 1 : 0;
+    }
+    CHECK(valid > 0 && valid < 300);
+}
+
+TEST(schemaKeepsTheLastDuplicateKey) {
+    JsonSchema named(parse(R"({"properties": {"name": {"pattern": "^[a-z]+$"}}})"));
+    CHECK(validateAll(named, R"({"name": "BAD", "name": "ok"})").empty());
+    CHECK(reportsAt(validateAll(named, R"({"name": "ok", "name": "BAD"})"), "/name"));
+
+    JsonSchema single(parse(R"({"maxProperties": 1})"));
+    CHECK(validateAll(single, R"({"a": 1, "a": 2})").empty());
+
+    JsonSchema records(parse(R"({"items": {"properties": {"name": {"pattern": "^[a-z]+$"}}, "maxProperties": 1}})"));
+    CHECK(validateAll(records, R"([{"name": "BAD", "name": "ok"}, {"a": 1, "a": 2}])").empty());
+}
+
+TEST(schemaRejectsTrailingData) {
+    CHECK(rejectedEverywhere(orderSchema(), R"({"id": 1, "items": []} {"id": 2})"));
+    CHECK(rejectedEverywhere(orderSchema(), R"({"id": 1, "items": []} 1)"));
+
+    JsonSchema anything(parse("{}"));
+    CHECK(rejectedEverywhere(anything, "[1, 2] garbage"));
+    CHECK(rejectedEverywhere(anything, "[] []"));
+    CHECK(rejectedEverywhere(anything, "[1] 2"));
+    CHECK(rejectedEverywhere(JsonSchema(parse(R"({"const": 1})")), "1 1"));
+}
+
+TEST(schemaSaturatesHugeBounds) {
+    JsonSchema schema(parse(R"({"type": "array", "minItems": 1e300, "maxItems": 1e30})"));
+    CHECK(!schema.isValid(parse("[1, 2, 3]")));
+    CHECK(JsonSchema(parse(R"({"maxLength": 1e30})")).isValid(parse(R"("abc")")));
+}
+
+TEST(schemaMatchesPatternsAgainstLongStrings) {
+    JsonSchema schema(parse(R"({"pattern": "^[a-z]+$"})"));
+    std::string text(200 * 1024, 'a');
+    CHECK(validateAll(schema, "\"" + text + "\"").empty());
+    text.back() = 'A';
+    CHECK(reportsAt(validateAll(schema, "\"" + text + "\""), "document root"));
+}
+
+TEST(schemaPatternsFollowEcmaScript) {
+    auto matches = [](const char* pattern, const char* text) { return json::JsonPattern(pattern).search(text); };
+    CHECK(matches("^(ab|a)*c$", "abaabc"));
+    CHECK(!matches("^(ab|a)*c$", "abbac"));
+    CHECK(matches("\\bfoo\\b", "a foo."));
+    CHECK(!matches("\\bfoo\\b", "afoo"));
+    CHECK(matches("^\\d{3}-\\d{4}$", "555-1234"));
+    CHECK(!matches("^\\d{3}-\\d{4}$", "555-12345"));
+    CHECK(matches("^[^\\s]{2}$", "\u00e9\u20ac"));   // code points, not bytes
+    CHECK(matches("a{", "a{"));
+    CHECK(!matches("^.$", "\n"));
+    CHECK_THROWS(json::JsonPattern("(a)\\1"));
+    CHECK_THROWS(json::JsonPattern("(?=a)"));
+    CHECK_THROWS(json::JsonPattern("a{2,1}"));
+}
+
+TEST(schemaRejectsUnsupportedKeywords) {
+    CHECK_THROWS(JsonSchema(parse(R"({"anyOf": [{"type": "string"}]})")));
+    CHECK_THROWS(JsonSchema(parse(R"({"minLength": -1})")));
+    CHECK_THROWS(JsonSchema(parse(R"({"pattern": "("})")));
+}
@@ -0,0 +1,88 @@
+#include "JsonParser.h"
+#include "JsonPrinter.h"
+#include "JsonStatic.h"
+#include "TestHarness.h"
+#include <cmath>
+#include <string_view>
+
+using json::JsonValue;
+using json_test::parse;
+
+namespace {
+
+#define CONFIG_TEXT                                                                              \
+    R"({"name": "json", "limits": {"depth": 64, "ratio": 0.75}, "tags": ["a", "b\n", "é😀"],)" \
+    R"( "on": true, "off": false, "none": null, "empty": {}, "list": []})"
+
+constexpr auto kConfig = JSON_STATIC(CONFIG_TEXT);
+
+static_assert(kConfig.isObject() && kConfig.size() == 8);
+static_assert(kConfig.keyAt(0) == "empty" && kConfig.keyAt(7) == "tags");   // sorted like JsonValue
+static_assert(kConfig["name"].asString() == "json");
+static_assert(kConfig["limits"]["depth"].asNumber() == 64);
+static_assert(kConfig["limits"]["ratio"].asNumber() == 0.75);
+static_assert(kConfig["tags"].size() == 3 && kConfig["tags"][1].asString() == "b\n");
+static_assert(kConfig["tags"][2].asString() == "é\U0001F600");
+static_assert(kConfig["on"].asBool() && !kConfig["off"].asBool() && kConfig["none"].isNull());
+static_assert(kConfig["empty"].isObject() && kConfig["empty"].size() == 0);
+static_assert(kConfig["list"].isArray() && kConfig["list"].size() == 0);
+static_assert(kConfig.hasKey("on") && !kConfig.hasKey("missing"));
+static_assert(JSON_STATIC(" -12.5e-1 ").asNumber() == -1.25);
+static_assert(JSON_STATIC("\"\"").asString().empty());
+
+// Decimal inputs whose correct rounding is hard to get right: halfway cases,
+// long mantissas, and the edges of the normal and subnormal ranges.
+#define HARD_NUMBERS_TEXT                                                                           \
+    "[0.1, 0.30000000000000004, 9007199254740993, 9007199254740995, 1e23, 8.98846567431158e307," \
+    " 1.7976931348623157e308, 2.2250738585072011e-308, 2.2250738585072014e-308,"                 \
+    " 4.9406564584124654e-324, 2.4703282292062328e-324, 2.4703282292062327e-324, 7.038531e-26,"  \
+    " 1.00000000000000011102230246251565404236316680908203125,"                                  \
+    " 1.00000000000000011102230246251565404236316680908203126,"                                  \
+    " 123456789012345678901234567890123456789012345678901234567890e-30, -0.0, 1e-400]"
+
+constexpr auto kHardNumbers = JSON_STATIC(HARD_NUMBERS_TEXT);
+
+// The compiler rounds each literal correctly, so these pin the static parser.
+static_assert(kHardNumbers[0].asNumber() == 0.1);
+static_assert(kHardNumbers[1].asNumber() == 0.30000000000000004);
+static_assert(kHardNumbers[2].asNumber() == 9007199254740992.0);
+static_assert(kHardNumbers[3].asNumber() == 9007199254740996.0);
+static_assert(kHardNumbers[4].asNumber() == 1e23);
+static_assert(kHardNumbers[5].asNumber() == 8.98846567431158e307);
+static_assert(kHardNumbers[6].asNumber() == 1.7976931348623157e308);
+static_assert(kHardNumbers[7].asNumber() == 2.2250738585072011e-308);
+static_assert(kHardNumbers[8].asNumber() == 2.2250738585072014e-308);
+static_assert(kHardNumbers[9].asNumber() == 4.9406564584124654e-324);
+static_assert(kHardNumbers[10].asNumber() == 4.9406564584124654e-324);
+static_assert(kHardNumbers[11].asNumber() == 0.0);
+static_assert(kHardNumbers[12].asNumber() == 7.038531e-26);
+static_assert(kHardNumbers[13].asNumber() == 1.0);
+static_assert(kHardNumbers[14].asNumber() == 1.0000000000000002);
+static_assert(kHardNumbers[15].asNumber() == 123456789012345678901234567890.0);
+static_assert(kHardNumbers[16].asNumber() == 0.0);
+static_assert(kHardNumbers[17].asNumber() == 0.0);
+
+} // namespace
+
+TEST(staticDocumentMatchesRuntimeParse) {
+    JsonValue converted = kConfig;
+    CHECK(converted == parse(CONFIG_TEXT));
+    CHECK(json::JsonPrinter::print(kConfig.toJsonValue()) == json::JsonPrinter::print(parse(CONFIG_TEXT)));
+    CHECK(kConfig["limits"].toJsonValue() == parse(R"({"depth": 64, "ratio": 0.75})"));
+}
+
+TEST(staticNumbersRoundLikeRuntimeParse) {
+    const JsonValue runtime = parse(HARD_NUMBERS_TEXT);
+    CHECK(kHardNumbers.toJsonValue() == runtime);
+    for (size_t i = 0; i < runtime.size(); ++i) {
+        // == does not tell -0.0 from 0.0.
+        CHECK(std::signbit(kHardNumbers[i].asNumber()) == std::signbit(runtime[i].asNumber()));
+        CHECK(kHardNumbers[i].asNumber() == runtime[i].asNumber());
+    }
+}
+
+TEST(staticLookupsThrowLikeJsonValue) {
+    CHECK_THROWS(kConfig["missing"]);
+    CHECK_THROWS(kConfig["tags"][3]);
+    CHECK_THROWS(kConfig["name"].asNumber());
+}
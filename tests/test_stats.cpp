@@ -0,0 +1,144 @@
+#include "JsonCursor.h"
+#include "JsonParser.h"
+#include "JsonPrinter.h"
+#include "JsonStats.h"
+#include "TestHarness.h"
+#include <chrono>
+#include <sstream>
+#include <string>
+
+using json::JsonParser;
+using json::JsonValue;
+using json::ParseStats;
+using json::Stats;
+using json::TokenType;
+using json::ValueType;
+
+namespace {
+
+const char* const kDocument = R"({"a": [1, "x", true, null], "b": {}})";
+
+// Enables collection for one test, starting from zeroed counters, and
+// restores the disabled default afterwards.
+class EnabledStats {
+public:
+    EnabledStats() {
+        Stats::reset();
+        Stats::setEnabled(true);
+    }
+    ~EnabledStats() {
+        Stats::setEnabled(false);
+        Stats::reset();
+    }
+};
+
+size_t tokens(const ParseStats& stats, TokenType type) {
+    return stats.tokens[static_cast<size_t>(type)];
+}
+
+size_t values(const ParseStats& stats, ValueType type) {
+    return stats.values[static_cast<size_t>(type)];
+}
+
+bool untouched(const ParseStats& stats) {
+    size_t counted = stats.bytesLexed + stats.bytesPrinted + stats.allocations + stats.maxDepth +
+                     stats.peakDocumentBytes;
+    for (size_t count : stats.tokens) counted += count;
+    for (size_t count : stats.values) counted += count;
+    return counted == 0 && stats.lexTime.count() == 0 && stats.parseTime.count() == 0 &&
+           stats.printTime.count() == 0;
+}
+
+void checkDocumentCounters(const ParseStats& stats) {
+    CHECK(tokens(stats, TokenType::LEFT_BRACE) == 2);
+    CHECK(tokens(stats, TokenType::RIGHT_BRACE) == 2);
+    CHECK(tokens(stats, TokenType::LEFT_BRACKET) == 1);
+    CHECK(tokens(stats, TokenType::RIGHT_BRACKET) == 1);
+    CHECK(tokens(stats, TokenType::COLON) == 2);
+    CHECK(tokens(stats, TokenType::COMMA) == 4);
+    CHECK(tokens(stats, TokenType::STRING) == 3);
+    CHECK(tokens(stats, TokenType::NUMBER) == 1);
+    CHECK(tokens(stats, TokenType::TRUE) == 1);
+    CHECK(tokens(stats, TokenType::NULL_TOKEN) == 1);
+    CHECK(tokens(stats, TokenType::END_OF_FILE) == 1);
+
+    CHECK(values(stats, ValueType::OBJECT) == 2);
+    CHECK(values(stats, ValueType::ARRAY) == 1);
+    CHECK(values(stats, ValueType::NUMBER) == 1);
+    CHECK(values(stats, ValueType::STRING) == 1);
+    CHECK(values(stats, ValueType::BOOLEAN) == 1);
+    CHECK(values(stats, ValueType::NULL_TYPE) == 1);
+
+    CHECK(stats.bytesLexed == std::string(kDocument).size());
+    CHECK(stats.maxDepth == 2);
+    CHECK(stats.allocations > 0);
+    CHECK(stats.peakDocumentBytes > 0);
+}
+
+} // namespace
+
+TEST(statsCountTokensValuesAndBytes) {
+    if (!Stats::compiledIn()) return;
+    EnabledStats enabled;
+
+    JsonValue document = JsonParser(kDocument).parse();
+    checkDocumentCounters(Stats::current());
+
+    std::string printed = json::JsonPrinter::print(document);
+    CHECK(Stats::current().bytesPrinted == printed.size());
+}
+
+TEST(statsCountStreamedInputTheSameWay) {
+    if (!Stats::compiledIn()) return;
+    EnabledStats enabled;
+
+    std::istringstream input(kDocument);
+    JsonParser(input).parse();
+    checkDocumentCounters(Stats::current());
+}
+
+TEST(statsDisabledLeaveCountersUntouched) {
+    Stats::reset();
+    Stats::setEnabled(false);
+    CHECK(!Stats::enabled());
+
+    JsonValue document = JsonParser(kDocument).parse();
+    std::istringstream input("[1, [2], {\"k\": 3}]");
+    json::JsonCursor cursor(input);
+    while (cursor.next()) cursor.readValue();
+    json::JsonPrinter::print(document, true);
+    CHECK(untouched(Stats::current()));
+
+    // Without JSON_ENABLE_STATS, enabling is a no-op as well.
+    if (!Stats::compiledIn()) {
+        Stats::setEnabled(true);
+        CHECK(!Stats::enabled());
+        JsonParser(kDocument).parse();
+        CHECK(untouched(Stats::current()));
+    }
+}
+
+TEST(statsPhaseTimesDoNotOverlap) {
+    if (!Stats::compiledIn()) return;
+    std::string text = "[";
+    for (int i = 0; i < 20000; ++i) {
+        text += i == 0 ? "" : ",";
+        text += R"({"id": )" + std::to_string(i) + R"(, "tags": ["a", "b"], "ok": true})";
+    }
+    text += "]";
+
+    EnabledStats enabled;
+    std::istringstream input(text);
+    auto start = std::chrono::steady_clock::now();
+    json::JsonCursor cursor(input);
+    while (cursor.next()) {
+        if (cursor.index() % 2) cursor.skip(); else cursor.readValue();
+    }
+    std::chrono::nanoseconds wall = std::chrono::steady_clock::now() - start;
+
+    // The parser lexes on demand here; lex time must not also count as parse time.
+    const ParseStats& stats = Stats::current();
+    CHECK(stats.lexTime.count() > 0);
+    CHECK(stats.parseTime.count() > 0);
+    CHECK(stats.lexTime + stats.parseTime <= wall);
+}
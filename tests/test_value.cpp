@@ -0,0 +1,80 @@
+#include "JsonPatch.h"
+#include "TestHarness.h"
+
+using json::JsonPatch;
+using json::JsonValue;
+using json_test::parse;
+
+TEST(copiesAreIsolatedFromMutation) {
+    const JsonValue original = parse(R"({"a": [1, {"b": 2}], "c": "d"})");
+    JsonValue copy = original;
+    copy.set("c", JsonValue("e"));
+    copy.erase("a");
+    CHECK(original == parse(R"({"a": [1, {"b": 2}], "c": "d"})"));
+    CHECK(copy == parse(R"({"c": "e"})"));
+}
+
+TEST(copyAfterLeakedObjectReferenceIsIsolated) {
+    JsonValue value = parse(R"({"k": 1, "n": {"x": 1}})");
+    JsonValue& member = value["k"];
+    JsonValue* found = value.find("n");
+    JsonValue copy = value;
+
+    member = JsonValue(2.0);
+    found->set("x", JsonValue(2.0));
+    CHECK(copy == parse(R"({"k": 1, "n": {"x": 1}})"));
+    CHECK(value == parse(R"({"k": 2, "n": {"x": 2}})"));
+}
+
+TEST(copyAfterLeakedArrayReferenceIsIsolated) {
+    JsonValue value = parse(R"([[1, 2], 3])");
+    JsonValue& inner = value[0];
+    JsonValue& leaf = inner[1];
+    JsonValue copy = value;
+
+    leaf = JsonValue(9.0);
+    inner.push_back(JsonValue(4.0));
+    CHECK(copy == parse(R"([[1, 2], 3])"));
+    CHECK(value == parse(R"([[1, 9, 4], 3])"));
+}
+
+TEST(leakedReferenceIntoSharedPayloadDoesNotReachCopies) {
+    JsonValue value = parse(R"({"list": [1, 2]})");
+    JsonValue before = value;          // shares the payload
+    JsonValue& list = value["list"];   // clones it for `value` first
+    JsonValue after = value;
+
+    list.push_back(JsonValue(3.0));
+    CHECK(before == parse(R"({"list": [1, 2]})"));
+    CHECK(after == parse(R"({"list": [1, 2]})"));
+    CHECK(value == parse(R"({"list": [1, 2, 3]})"));
+}
+
+TEST(patchedDocumentCopiesStayIsolated) {
+    JsonValue value = parse(R"({"a": {"b": [1, 2]}})");
+    JsonPatch::apply(value, parse(R"([{"op": "add", "path": "/a/b/-", "value": 3}])"));
+    JsonValue copy = value;
+    JsonPatch::apply(value, parse(R"([{"op": "replace", "path": "/a/b/0", "value": 0}])"));
+    CHECK(copy == parse(R"({"a": {"b": [1, 2, 3]}})"));
+    CHECK(value == parse(R"({"a": {"b": [0, 2, 3]}})"));
+}
+
+TEST(copyOfDeeplyLeakedDocumentDoesNotRecurse) {
+    const size_t depth = 100000;
+    JsonValue root = JsonValue::makeArray();
+    JsonValue* innermost = &root;
+    for (size_t i = 0; i < depth; ++i) {
+        innermost->push_back(JsonValue::makeArray());
+        innermost = &(*innermost)[0];   // leaks every level
+    }
+    innermost->push_back(JsonValue(1.0));
+
+    JsonValue copy = root;
+    (*innermost)[0] = JsonValue(2.0);
+
+    const JsonValue* level = &copy;
+    for (size_t i = 0; i < depth; ++i) {
+        level = &level->getArray()[0];
+    }
+    CHECK(level->getArray()[0].asNumber() == 1.0);
+}